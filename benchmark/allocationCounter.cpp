@@ -0,0 +1,29 @@
+#include "allocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+// linked in each benchmark binary for replace the global operator new
+
+static std::size_t s_allocations = 0;
+
+std::size_t benchmark::blet::allocations() {
+    return __atomic_load_n(&s_allocations, __ATOMIC_RELAXED);
+}
+
+void* operator new(std::size_t size) {
+    __atomic_add_fetch(&s_allocations, 1, __ATOMIC_RELAXED);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) throw() {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) throw() {
+    std::free(ptr);
+}
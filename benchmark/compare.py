@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+"""Compare a benchmark result with a saved baseline.
+
+usage:
+    ./load.blet_conf.benchmark --benchmark_out=baseline.json --benchmark_out_format=json
+    ./load.blet_conf.benchmark --benchmark_out=current.json --benchmark_out_format=json
+    python3 compare.py baseline.json current.json [--threshold 5]
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        data = json.load(f)
+    results = {}
+    for benchmark in data["benchmarks"]:
+        if benchmark.get("run_type", "iteration") != "iteration":
+            continue
+        results[benchmark["name"]] = benchmark
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="json output of the baseline")
+    parser.add_argument("current", help="json output of the current build")
+    parser.add_argument("--threshold", type=float, default=5.0, help="regression threshold in percent (default: 5)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+    print("{:<32} {:>12} {:>12} {:>8} {:>12} {:>12}".format("name", "base MB/s", "curr MB/s", "diff",
+                                                           "base a/node", "curr a/node"))
+    for name, result in current.items():
+        if name not in baseline:
+            continue
+        base = baseline[name]
+        baseSpeed = base.get("bytes_per_second", 0.0) / 1e6
+        currSpeed = result.get("bytes_per_second", 0.0) / 1e6
+        diff = (currSpeed - baseSpeed) * 100.0 / baseSpeed if baseSpeed else 0.0
+        baseAllocs = base.get("allocs/node", 0.0)
+        currAllocs = result.get("allocs/node", 0.0)
+        mark = ""
+        if diff < -args.threshold or currAllocs > baseAllocs * (1.0 + args.threshold / 100.0):
+            mark = " <- regression"
+            regressions += 1
+        label = name + (" " + result["label"] if result.get("label") else "")
+        print("{:<32} {:>12.2f} {:>12.2f} {:>7.1f}% {:>12.3f} {:>12.3f}{}".format(label, baseSpeed, currSpeed, diff,
+                                                                                 baseAllocs, currAllocs, mark))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include "allocationCounter.h"
+#include "blet/conf.h"
+#include "corpus.h"
+
+static void s_dump(benchmark::State& state, blet::conf::EDumpStyle style, std::size_t indent) {
+    const blet::Dict dict =
+        blet::conf::loadString(benchmark::blet::corpus(static_cast<benchmark::blet::ECorpus>(state.range(0))));
+    std::size_t nodes = benchmark::blet::countNodes(dict);
+    std::size_t size = 0;
+    std::size_t allocations = benchmark::blet::allocations();
+    while (state.KeepRunning()) {
+        std::string str = blet::conf::dump(dict, indent, ' ', style);
+        size = str.size();
+        benchmark::DoNotOptimize(str);
+    }
+    allocations = benchmark::blet::allocations() - allocations;
+    state.SetLabel(benchmark::blet::s_corpusNames[state.range(0)]);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.counters["nodes"] = static_cast<double>(nodes);
+    state.counters["allocs/node"] =
+        static_cast<double>(allocations) / static_cast<double>(state.iterations()) / static_cast<double>(nodes);
+}
+
+static void dumpConf(benchmark::State& state) {
+    s_dump(state, blet::conf::CONF_STYLE, 2);
+}
+BENCHMARK(dumpConf)->DenseRange(0, benchmark::blet::CORPUS_COUNT - 1)->Unit(benchmark::kMillisecond);
+
+static void dumpJson(benchmark::State& state) {
+    s_dump(state, blet::conf::JSON_STYLE, 2);
+}
+BENCHMARK(dumpJson)->DenseRange(0, benchmark::blet::CORPUS_COUNT - 1)->Unit(benchmark::kMillisecond);
+
+// compact output without indentation
+static void dumpConfCompact(benchmark::State& state) {
+    s_dump(state, blet::conf::CONF_STYLE, 0);
+}
+BENCHMARK(dumpConfCompact)->DenseRange(0, benchmark::blet::CORPUS_COUNT - 1)->Unit(benchmark::kMillisecond);
+
+static void dumpJsonCompact(benchmark::State& state) {
+    s_dump(state, blet::conf::JSON_STYLE, 0);
+}
+BENCHMARK(dumpJsonCompact)->DenseRange(0, benchmark::blet::CORPUS_COUNT - 1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,17 @@
+#ifndef _BENCHMARK_BLET_ALLOCATION_COUNTER_H_
+#define _BENCHMARK_BLET_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+namespace benchmark {
+namespace blet {
+
+/**
+ * @brief Get the number of allocations by the global operator new since the start of program.
+ */
+std::size_t allocations();
+
+} // namespace blet
+} // namespace benchmark
+
+#endif // _BENCHMARK_BLET_ALLOCATION_COUNTER_H_
@@ -0,0 +1,114 @@
+#ifndef _BENCHMARK_BLET_CORPUS_H_
+#define _BENCHMARK_BLET_CORPUS_H_
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include "blet/dict.h"
+
+namespace benchmark {
+namespace blet {
+
+enum ECorpus {
+    NUMERIC_CORPUS = 0,
+    STRING_CORPUS,
+    NESTED_CORPUS,
+    WIDE_CORPUS,
+    ARRAY_CORPUS,
+    JSON_CORPUS,
+    COMMENT_CORPUS,
+    CORPUS_COUNT
+};
+
+static const char* const s_corpusNames[CORPUS_COUNT] = {"numeric", "string", "nested", "wide",
+                                                        "array",   "json",   "comment"};
+
+// approximate size of a generated corpus
+static const std::size_t s_corpusSize = 1024 * 1024;
+
+/**
+ * @brief Generate a deterministic config of about s_corpusSize bytes.
+ */
+inline std::string corpus(ECorpus type) {
+    std::ostringstream oss("");
+    std::size_t i = 0;
+    while (static_cast<std::size_t>(oss.tellp()) < s_corpusSize) {
+        switch (type) {
+            case NUMERIC_CORPUS:
+                if (i % 20 == 0) {
+                    oss << "[section" << i / 20 << "]\n";
+                }
+                oss << "int" << i << " = " << i * 7 << "\n"
+                    << "float" << i << " = " << i << ".25e-3\n"
+                    << "hex" << i << " = 0x" << std::hex << i << std::dec << "\n";
+                break;
+            case STRING_CORPUS:
+                if (i % 20 == 0) {
+                    oss << "[section" << i / 20 << "]\n";
+                }
+                oss << "quoted" << i << " = \"value " << i << " with \\\"escape\\\"\\n and tab\\t\"\n"
+                    << "bare" << i << " = bare value number " << i << "\n";
+                break;
+            case NESTED_CORPUS:
+                oss << "[root" << i << "]\n";
+                for (std::size_t level = 2; level <= 16; ++level) {
+                    oss << std::string(level, '[') << "level" << level << std::string(level, ']') << "\n"
+                        << "key = " << level << "\n";
+                }
+                break;
+            case WIDE_CORPUS:
+                if (i == 0) {
+                    oss << "[wide]\n";
+                }
+                oss << "key" << i << " = " << i << "\n";
+                break;
+            case ARRAY_CORPUS:
+                if (i == 0) {
+                    oss << "[array]\n";
+                }
+                oss << "values[] = " << i << "\n";
+                break;
+            case JSON_CORPUS:
+                oss << "object" << i << " = { name = \"object " << i << "\", id = " << i
+                    << ", tags = [foo, bar, baz], child = { enabled = true, ratio = 0.5, list = [1, 2, { deep = "
+                    << i << " }] } }\n";
+                break;
+            case COMMENT_CORPUS:
+                if (i % 20 == 0) {
+                    oss << "; section comment " << i << "\n[section" << i / 20 << "]\n";
+                }
+                oss << "# comment line with some text about the next value " << i << "\n"
+                    << "key" << i << " = " << i << " ; trailing comment\n";
+                break;
+            case CORPUS_COUNT:
+                break;
+        }
+        ++i;
+    }
+    return oss.str();
+}
+
+/**
+ * @brief Count the nodes of a dict.
+ */
+inline std::size_t countNodes(const ::blet::Dict& dict) {
+    std::size_t count = 1;
+    if (dict.isObject()) {
+        for (::blet::Dict::object_t::const_iterator cit = dict.getValue().getObject().begin();
+             cit != dict.getValue().getObject().end(); ++cit) {
+            count += countNodes(cit->second);
+        }
+    }
+    else if (dict.isArray()) {
+        for (std::size_t i = 0; i < dict.getValue().getArray().size(); ++i) {
+            count += countNodes(dict.getValue().getArray()[i]);
+        }
+    }
+    return count;
+}
+
+} // namespace blet
+} // namespace benchmark
+
+#endif // _BENCHMARK_BLET_CORPUS_H_
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "allocationCounter.h"
+#include "blet/conf.h"
+#include "corpus.h"
+
+static void s_setCounters(benchmark::State& state, std::size_t size, std::size_t allocations, std::size_t nodes) {
+    state.SetLabel(benchmark::blet::s_corpusNames[state.range(0)]);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.counters["nodes"] = static_cast<double>(nodes);
+    state.counters["allocs/node"] =
+        static_cast<double>(allocations) / static_cast<double>(state.iterations()) / static_cast<double>(nodes);
+}
+
+static void loadString(benchmark::State& state) {
+    const std::string str = benchmark::blet::corpus(static_cast<benchmark::blet::ECorpus>(state.range(0)));
+    std::size_t nodes = benchmark::blet::countNodes(blet::conf::loadString(str));
+    std::size_t allocations = benchmark::blet::allocations();
+    while (state.KeepRunning()) {
+        blet::Dict dict = blet::conf::loadString(str);
+        benchmark::DoNotOptimize(dict);
+    }
+    s_setCounters(state, str.size(), benchmark::blet::allocations() - allocations, nodes);
+}
+BENCHMARK(loadString)->DenseRange(0, benchmark::blet::CORPUS_COUNT - 1)->Unit(benchmark::kMillisecond);
+
+static void loadData(benchmark::State& state) {
+    const std::string str = benchmark::blet::corpus(static_cast<benchmark::blet::ECorpus>(state.range(0)));
+    std::size_t nodes = benchmark::blet::countNodes(blet::conf::loadData(str.data(), str.size()));
+    std::size_t allocations = benchmark::blet::allocations();
+    while (state.KeepRunning()) {
+        blet::Dict dict = blet::conf::loadData(str.data(), str.size());
+        benchmark::DoNotOptimize(dict);
+    }
+    s_setCounters(state, str.size(), benchmark::blet::allocations() - allocations, nodes);
+}
+BENCHMARK(loadData)->DenseRange(0, benchmark::blet::CORPUS_COUNT - 1)->Unit(benchmark::kMillisecond);
+
+static void loadFile(benchmark::State& state) {
+    const std::string str = benchmark::blet::corpus(static_cast<benchmark::blet::ECorpus>(state.range(0)));
+    char filename[] = "/tmp/blet_benchmark_loadFile.XXXXXX";
+    int fd = ::mkstemp(filename);
+    if (fd < 0) {
+        state.SkipWithError("Create temporary file failed");
+        return;
+    }
+    ::close(fd);
+    std::ofstream ofs(filename);
+    ofs << str;
+    ofs.close();
+    std::size_t nodes = benchmark::blet::countNodes(blet::conf::loadFile(filename));
+    std::size_t allocations = benchmark::blet::allocations();
+    while (state.KeepRunning()) {
+        blet::Dict dict = blet::conf::loadFile(filename);
+        benchmark::DoNotOptimize(dict);
+    }
+    s_setCounters(state, str.size(), benchmark::blet::allocations() - allocations, nodes);
+    std::remove(filename);
+}
+BENCHMARK(loadFile)->DenseRange(0, benchmark::blet::CORPUS_COUNT - 1)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -26,9 +26,21 @@
 #ifndef BLET_CONF_H_
 #define BLET_CONF_H_
 
+#include <string.h>
+
+#include <cmath>     // std::floor, std::ldexp
 #include <exception> // std::exception
+#include <limits>    // std::numeric_limits
+#include <list>      // std::list
+#include <map>       // std::map
 #include <sstream>   // std::istream, std::ostream
+#include <stdexcept> // std::invalid_argument, std::out_of_range
 #include <string>    // std::string
+#include <vector>    // std::vector
+
+#if __cplusplus >= 201703L
+#include <string_view> // std::string_view
+#endif
 
 #include "blet/dict.h"
 
@@ -58,11 +70,118 @@ class LoadException : public std::exception {
     std::size_t column_;
 };
 
+/**
+ * @brief Dump exception from std::exception
+ */
+class DumpException : public std::exception {
+  public:
+    DumpException(const std::string& filename, const std::string& message);
+    ~DumpException() throw();
+    const char* what() const throw();
+    const std::string& filename() const throw();
+    const std::string& message() const throw();
+
+  protected:
+    std::string what_;
+    std::string filename_;
+    std::string message_;
+};
+
+/**
+ * @brief Merge exception from std::exception
+ */
+class MergeException : public std::exception {
+  public:
+    MergeException(const std::string& path, const std::string& message);
+    ~MergeException() throw();
+    const char* what() const throw();
+    const std::string& path() const throw();
+    const std::string& message() const throw();
+
+  protected:
+    std::string what_;
+    std::string path_;
+    std::string message_;
+};
+
+/**
+ * @brief Bind exception from std::exception with all the errors of a bind
+ */
+class BindException : public std::exception {
+  public:
+    BindException(const std::vector<LoadException>& errors);
+    ~BindException() throw();
+    const char* what() const throw();
+    const std::vector<LoadException>& errors() const throw();
+
+  protected:
+    std::string what_;
+    std::vector<LoadException> errors_;
+};
+
 enum EDumpStyle {
     CONF_STYLE = 0,
     JSON_STYLE
 };
 
+/**
+ * @brief Statistics of dump.
+ */
+struct DumpStats {
+    DumpStats() {
+        clear();
+    }
+
+    /**
+     * @brief Reset all the statistics.
+     */
+    void clear() {
+        bytes = 0;
+        for (std::size_t i = 0; i < sizeof(nodes) / sizeof(*nodes); ++i) {
+            nodes[i] = 0;
+        }
+        quotedKeys = 0;
+        escapedStrings = 0;
+        numberTime = 0.0;
+        structureTime = 0.0;
+        flushes = 0;
+        reallocations = 0;
+    }
+
+    /**
+     * @brief Size of the written output.
+     */
+    std::size_t bytes;
+    /**
+     * @brief Number of the dumped values by blet::Dict::EType.
+     */
+    std::size_t nodes[blet::Dict::OBJECT_TYPE + 1];
+    /**
+     * @brief Number of the keys written in quotes.
+     */
+    std::size_t quotedKeys;
+    /**
+     * @brief Number of the keys and strings with escaped characters.
+     */
+    std::size_t escapedStrings;
+    /**
+     * @brief Time in seconds of the formatting of numbers.
+     */
+    double numberTime;
+    /**
+     * @brief Time in seconds of the dump without the formatting of numbers.
+     */
+    double structureTime;
+    /**
+     * @brief Number of the writes of buffer in the file descriptor (dumpFd and dumpFile).
+     */
+    std::size_t flushes;
+    /**
+     * @brief Number of the growths of output string (dump in a string).
+     */
+    std::size_t reallocations;
+};
+
 /**
  * @brief Dump dict in config format.
  *
@@ -71,9 +190,10 @@ enum EDumpStyle {
  * @param indent Indentation of dump.
  * @param indentCharacter Indentation character.
  * @param style Style of dump.
+ * @param stats If not NULL, cleared then filled with the statistics of dump.
  */
 void dump(const blet::Dict& dict, std::ostream& os, std::size_t indent = 0, char indentCharacter = ' ',
-          enum EDumpStyle style = CONF_STYLE);
+          enum EDumpStyle style = CONF_STYLE, DumpStats* stats = NULL);
 
 /**
  * @brief Dump dict in config format.
@@ -82,43 +202,1529 @@ void dump(const blet::Dict& dict, std::ostream& os, std::size_t indent = 0, char
  * @param indent Indentation of dump.
  * @param indentCharacter Indentation character.
  * @param style Style of dump.
+ * @param stats If not NULL, cleared then filled with the statistics of dump.
  * @return std::string config string.
  */
 std::string dump(const blet::Dict& dict, std::size_t indent = 0, char indentCharacter = ' ',
-                 enum EDumpStyle style = CONF_STYLE);
+                 enum EDumpStyle style = CONF_STYLE, DumpStats* stats = NULL);
+
+/**
+ * @brief Dump dict in config format at the end of a string.
+ * The capacity of @p str is reused, clear the string and keep it between calls for avoid allocations.
+ *
+ * @param dict A dict.
+ * @param str A string where the dump is appended.
+ * @param indent Indentation of dump.
+ * @param indentCharacter Indentation character.
+ * @param style Style of dump.
+ * @param stats If not NULL, cleared then filled with the statistics of dump.
+ */
+void dump(const blet::Dict& dict, std::string& str, std::size_t indent = 0, char indentCharacter = ' ',
+          enum EDumpStyle style = CONF_STYLE, DumpStats* stats = NULL);
+
+/**
+ * @brief Dump dict in config format in a file descriptor.
+ * The output is written by large blocks with writev.
+ *
+ * @param dict A dict.
+ * @param fd A file descriptor opened in write mode.
+ * @param indent Indentation of dump.
+ * @param indentCharacter Indentation character.
+ * @param style Style of dump.
+ * @param stats If not NULL, cleared then filled with the statistics of dump.
+ * @throw DumpException if write failed.
+ */
+void dumpFd(const blet::Dict& dict, int fd, std::size_t indent = 0, char indentCharacter = ' ',
+            enum EDumpStyle style = CONF_STYLE, DumpStats* stats = NULL);
+
+/**
+ * @brief Dump dict in config format in a file.
+ * The dump is written in a temporary file renamed at the end, the readers of filename never see a partial config.
+ *
+ * @param dict A dict.
+ * @param filename A filename.
+ * @param indent Indentation of dump.
+ * @param indentCharacter Indentation character.
+ * @param style Style of dump.
+ * @param stats If not NULL, cleared then filled with the statistics of dump.
+ * @throw DumpException if open, write or rename failed.
+ */
+void dumpFile(const blet::Dict& dict, const char* filename, std::size_t indent = 0, char indentCharacter = ' ',
+              enum EDumpStyle style = CONF_STYLE, DumpStats* stats = NULL);
+
+/**
+ * @brief Dump dict in config format with the first level sections rendered in parallel.
+ * The output is the same as the dump function.
+ *
+ * @param dict A dict.
+ * @param os A ostream.
+ * @param indent Indentation of dump.
+ * @param indentCharacter Indentation character.
+ * @param style Style of dump.
+ * @param threads Number of threads (0 for the number of online processors).
+ */
+void parallelDump(const blet::Dict& dict, std::ostream& os, std::size_t indent = 0, char indentCharacter = ' ',
+                  enum EDumpStyle style = CONF_STYLE, std::size_t threads = 0);
+
+/**
+ * @brief Dump dict in config format with the first level sections rendered in parallel.
+ * The output is the same as the dump function.
+ *
+ * @param dict A dict.
+ * @param indent Indentation of dump.
+ * @param indentCharacter Indentation character.
+ * @param style Style of dump.
+ * @param threads Number of threads (0 for the number of online processors).
+ * @return std::string config string.
+ */
+std::string parallelDump(const blet::Dict& dict, std::size_t indent = 0, char indentCharacter = ' ',
+                         enum EDumpStyle style = CONF_STYLE, std::size_t threads = 0);
+
+/**
+ * @brief Interface of memory for the read buffers of load.
+ * It is a hook for allocate and account the transient buffers of the loaded files and streams only:
+ * the loaded tree is not stored in the resource, its nodes, keys and strings are always allocated by the global
+ * operator new.
+ */
+class MemoryResource {
+  public:
+    virtual ~MemoryResource() {}
+
+    /**
+     * @brief Allocate a buffer.
+     *
+     * @param size Size of buffer.
+     * @return void* The buffer.
+     * @throw std::bad_alloc if the allocation failed.
+     */
+    virtual void* allocate(std::size_t size) = 0;
+
+    /**
+     * @brief Deallocate a buffer returned by allocate.
+     *
+     * @param pointer The buffer.
+     * @param size Size of buffer.
+     */
+    virtual void deallocate(void* pointer, std::size_t size) = 0;
+};
+
+/**
+ * @brief Get the resource of the global operator new and delete.
+ *
+ * @return MemoryResource& The resource.
+ */
+MemoryResource& newDeleteResource();
+
+/**
+ * @brief Account the memory allocated by a upstream resource.
+ */
+class CountingMemoryResource : public MemoryResource {
+  public:
+    explicit CountingMemoryResource(MemoryResource& upstream = newDeleteResource());
+    ~CountingMemoryResource();
+
+    void* allocate(std::size_t size);
+    void deallocate(void* pointer, std::size_t size);
+
+    /**
+     * @brief Get the size of the memory currently allocated.
+     *
+     * @return std::size_t Size in bytes.
+     */
+    std::size_t allocated() const;
+
+    /**
+     * @brief Get the maximum size of the memory allocated at the same time.
+     *
+     * @return std::size_t Size in bytes.
+     */
+    std::size_t peak() const;
+
+    /**
+     * @brief Get the number of allocations.
+     *
+     * @return std::size_t Number of allocations.
+     */
+    std::size_t allocations() const;
+
+  private:
+    CountingMemoryResource(const CountingMemoryResource&);
+    CountingMemoryResource& operator=(const CountingMemoryResource&);
+
+    MemoryResource& upstream_;
+    std::size_t allocated_;
+    std::size_t peak_;
+    std::size_t allocations_;
+};
+
+/**
+ * @brief Side table of the source locations of the loaded values.
+ * The locations are recorded by path in parallel arrays out of the dict,
+ * the line and column are computed only at the lookup.
+ */
+class SourceMap {
+  public:
+    struct Location {
+        std::string filename;
+        std::size_t offset;
+        std::size_t line;
+        std::size_t column;
+    };
+
+    SourceMap();
+    ~SourceMap();
+
+    /**
+     * @brief Remove all the records.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of records.
+     *
+     * @return std::size_t Number of records.
+     */
+    std::size_t size() const {
+        return parents_.size();
+    }
+
+    /**
+     * @brief Find the location of the last assignment of a value.
+     *
+     * @param path A path of value (see Accessor).
+     * @param location The location found.
+     * @return true if the path is found.
+     * @throw std::invalid_argument if the path is not valid.
+     */
+    bool find(const std::string& path, Location& location) const;
+
+    /**
+     * @brief Create a exception at the location of @p path.
+     *
+     * @param path A path of value (see Accessor).
+     * @param message The message of exception.
+     * @return LoadException The exception with the line and column if the path is found.
+     */
+    LoadException locate(const std::string& path, const std::string& message) const;
+
+  private:
+    friend class Loader;
+    friend class Interpolator;
+
+    SourceMap(const SourceMap&);
+    SourceMap& operator=(const SourceMap&);
+
+    std::size_t addFile(const std::string& filename, const char* content, std::size_t size);
+    std::size_t add(std::size_t parent, const std::string& key, std::size_t offset, std::size_t file);
+    std::size_t add(std::size_t parent, std::size_t index, std::size_t offset, std::size_t file);
+    void append(const SourceMap& sourceMap, std::size_t parent, const std::vector<std::size_t>& indexShifts);
+    void location(std::size_t record, Location& location) const;
+
+    std::vector<std::size_t> parents_;
+    std::vector<std::string> keys_;
+    std::vector<std::size_t> indexes_;
+    std::vector<std::size_t> offsets_;
+    std::vector<std::size_t> files_;
+    std::vector<std::string> filenames_;
+    std::vector<std::vector<std::size_t> > lineStarts_;
+};
+
+/**
+ * @brief Statistics of load.
+ */
+struct LoadStats {
+    LoadStats() {
+        clear();
+    }
+
+    /**
+     * @brief Reset all the statistics.
+     */
+    void clear() {
+        bytes = 0;
+        readTime = 0.0;
+        parseTime = 0.0;
+        for (std::size_t i = 0; i < sizeof(nodes) / sizeof(*nodes); ++i) {
+            nodes[i] = 0;
+        }
+        maxDepth = 0;
+        files = 0;
+        sections = 0;
+        appends = 0;
+        escapedStrings = 0;
+        decimalNumbers = 0;
+        hexadecimalNumbers = 0;
+        binaryNumbers = 0;
+        octalNumbers = 0;
+    }
+
+    /**
+     * @brief Size of the read contents (with the included files).
+     */
+    std::size_t bytes;
+    /**
+     * @brief Time in seconds of the reads of contents.
+     */
+    double readTime;
+    /**
+     * @brief Time in seconds of the parse (without the reads of included files).
+     */
+    double parseTime;
+    /**
+     * @brief Number of the values of loaded dict by blet::Dict::EType.
+     */
+    std::size_t nodes[blet::Dict::OBJECT_TYPE + 1];
+    /**
+     * @brief Maximum depth of loaded dict (0 for a root without child).
+     */
+    std::size_t maxDepth;
+    /**
+     * @brief Number of the read contents (1 + the included files).
+     */
+    std::size_t files;
+    /**
+     * @brief Number of the section headers.
+     */
+    std::size_t sections;
+    /**
+     * @brief Number of the `key[]` appends.
+     */
+    std::size_t appends;
+    /**
+     * @brief Number of the strings with escape sequences.
+     */
+    std::size_t escapedStrings;
+    std::size_t decimalNumbers;
+    std::size_t hexadecimalNumbers;
+    std::size_t binaryNumbers;
+    std::size_t octalNumbers;
+};
+
+/**
+ * @brief Options of load.
+ */
+struct LoadOptions {
+    LoadOptions() :
+        sourceMap(NULL),
+        interpolation(false),
+        memoryResource(NULL),
+        stats(NULL) {}
+
+    /**
+     * @brief If not NULL, cleared then filled with the locations of the loaded values.
+     */
+    SourceMap* sourceMap;
+
+    /**
+     * @brief Replace the `${path.of.value}` and `${ENVIRONMENT}` references of the strings after the load.
+     * A string with only one reference takes the type of the referenced value, `$${` is a escaped `${`.
+     */
+    bool interpolation;
+
+    /**
+     * @brief If not NULL, resource of the read buffers of load only (the read content of the files), released at the
+     * end of load. The nodes of the loaded dict are allocated by the global operator new.
+     */
+    MemoryResource* memoryResource;
+
+    /**
+     * @brief If not NULL, cleared then filled with the statistics of load.
+     * Without statistics, the loader only checks a pointer.
+     */
+    LoadStats* stats;
+};
 
 /**
  * @brief Load a config from filename.
  *
  * @param filename A filename.
+ * @param options Options of load.
  * @return blet::Dict Dictionnary of config.
  */
-blet::Dict loadFile(const char* filename);
+blet::Dict loadFile(const char* filename, const LoadOptions& options = LoadOptions());
 
 /**
  * @brief Load a config from stream.
  *
  * @param stream A stream.
+ * @param options Options of load.
  * @return blet::Dict Dictionnary of config.
  */
-blet::Dict loadStream(std::istream& stream);
+blet::Dict loadStream(std::istream& stream, const LoadOptions& options = LoadOptions());
 
 /**
  * @brief Load a config from string.
  *
  * @param str A string.
+ * @param options Options of load.
  * @return blet::Dict Dictionnary of config.
  */
-blet::Dict loadString(const std::string& str);
+blet::Dict loadString(const std::string& str, const LoadOptions& options = LoadOptions());
 
 /**
  * @brief Load a config from data.
  *
  * @param data A data.
  * @param size Size of data.
+ * @param options Options of load.
  * @return blet::Dict Dictionnary of config.
  */
-blet::Dict loadData(const void* data, std::size_t size);
+blet::Dict loadData(const void* data, std::size_t size, const LoadOptions& options = LoadOptions());
+
+/**
+ * @brief Paths of the changes applied by a reload.
+ */
+struct Changes {
+    /**
+     * @brief Return true if the reload has not changed the dict.
+     */
+    bool empty() const;
+
+    std::vector<blet::Dict::Path> added;
+    std::vector<blet::Dict::Path> removed;
+    std::vector<blet::Dict::Path> modified;
+};
+
+/**
+ * @brief Apply the differences of @p newDict in @p dict.
+ * The unchanged nodes of @p dict are kept at the same address and the changed nodes are moved from @p newDict
+ * without copy.
+ * The elements of a growing array can be relocated but their contents are kept.
+ *
+ * @param dict A dict to update.
+ * @param newDict A new version of dict (its content is consumed).
+ * @return Changes Paths of added, removed and modified nodes.
+ */
+Changes reload(blet::Dict& dict, blet::Dict& newDict);
+
+/**
+ * @brief Load a config from filename and apply the differences in @p dict.
+ * If the load failed the dict is not modified.
+ *
+ * @param dict A dict to update.
+ * @param filename A filename.
+ * @return Changes Paths of added, removed and modified nodes.
+ */
+Changes reloadFile(blet::Dict& dict, const char* filename);
+
+enum EMergePolicy {
+    OVERRIDE_POLICY = 0,
+    APPEND_POLICY,
+    ERROR_POLICY
+};
+
+/**
+ * @brief Merge a layer of config in @p dict.
+ * The objects are merged by key and the other values of @p layer replace the values of @p dict
+ * (OVERRIDE_POLICY), the arrays are appended (APPEND_POLICY) or a different value throws (ERROR_POLICY).
+ * The content of @p layer is moved (swap) in @p dict, the unchanged values of @p dict are not copied.
+ *
+ * @param dict A dict to update.
+ * @param layer A dict to merge.
+ * @param policy Policy of the values in @p dict and @p layer.
+ * @throw MergeException with ERROR_POLICY if a value is different, the dicts are not modified.
+ */
+void merge(blet::Dict& dict, blet::Dict& layer, enum EMergePolicy policy = OVERRIDE_POLICY);
+
+/**
+ * @brief Holder of the current config shared between threads.
+ * The readers access the last published dict without lock and wait, the replaced dicts are deleted when they are
+ * no longer read (epoch based reclamation).
+ */
+class Snapshot {
+  private:
+    struct Document;
+    struct Mutex;
+
+  public:
+    /**
+     * @brief Read access of a thread, create one reader by thread and keep it.
+     */
+    class Reader {
+      public:
+        Reader(Snapshot& snapshot);
+        ~Reader();
+
+        /**
+         * @brief Start a read of the current dict, the dict is valid until unlock.
+         *
+         * @return const blet::Dict& Reference of current dict.
+         */
+        const blet::Dict& lock();
+
+        /**
+         * @brief End the read started by lock.
+         */
+        void unlock();
+
+        /**
+         * @brief Get the version of the locked dict.
+         *
+         * @return unsigned long Version of the locked dict or 0 if the reader is not locked.
+         */
+        unsigned long version() const;
+
+      private:
+        Reader(const Reader&);
+        Reader& operator=(const Reader&);
+
+        Snapshot& snapshot_;
+        unsigned long* epoch_;
+        std::size_t nested_;
+        const Document* document_;
+    };
+
+    /**
+     * @brief Scoped lock of a reader.
+     */
+    class Guard {
+      public:
+        Guard(Reader& reader) :
+            reader_(reader),
+            dict_(reader.lock()) {}
+
+        ~Guard() {
+            reader_.unlock();
+        }
+
+        const blet::Dict& operator*() const {
+            return dict_;
+        }
+
+        const blet::Dict* operator->() const {
+            return &dict_;
+        }
+
+        unsigned long version() const {
+            return reader_.version();
+        }
+
+      private:
+        Guard(const Guard&);
+        Guard& operator=(const Guard&);
+
+        Reader& reader_;
+        const blet::Dict& dict_;
+    };
+
+    Snapshot();
+    ~Snapshot();
+
+    /**
+     * @brief Publish a new version of dict for the next reads.
+     * The content of @p dict is moved (swap) in the snapshot.
+     *
+     * @param dict A dict.
+     */
+    void publish(blet::Dict& dict);
+
+    /**
+     * @brief Delete the replaced dicts which are no longer read.
+     *
+     * @return std::size_t Number of dicts not yet deleted.
+     */
+    std::size_t reclaim();
+
+    /**
+     * @brief Get the version of the last published dict.
+     */
+    unsigned long version() const;
+
+  private:
+    Snapshot(const Snapshot&);
+    Snapshot& operator=(const Snapshot&);
+
+    std::size_t reclaimLocked();
+
+    Document* current_;
+    unsigned long epoch_;
+    unsigned long version_;
+    std::list<unsigned long*> readers_;
+    std::list<Document*> retired_;
+    Mutex* mutex_;
+};
+
+/**
+ * @brief Watch a config file with inotify and publish its new versions in a snapshot.
+ * The bursts of write are merged by a debounce delay and the file is reloaded in a background thread.
+ */
+class Watcher {
+  public:
+    /**
+     * @brief Receiver of the reload events, called from the thread of watcher.
+     */
+    class Listener {
+      public:
+        virtual ~Listener() {}
+
+        /**
+         * @brief Called after the publish of a new version.
+         *
+         * @param version Version of published dict.
+         */
+        virtual void onReload(unsigned long version) {
+            static_cast<void>(version);
+        }
+
+        /**
+         * @brief Called when the reload failed, the previous version is kept.
+         * The others exceptions of reload (like a exception of onReload) are given with the filename of config.
+         *
+         * @param e Exception of load.
+         */
+        virtual void onError(const LoadException& e) {
+            static_cast<void>(e);
+        }
+    };
+
+    /**
+     * @brief Construct a new Watcher object.
+     *
+     * @param filename A filename of config.
+     * @param snapshot The snapshot where the config is published.
+     * @param listener Optional receiver of events.
+     * @param debounce Delay in milliseconds without change before reload.
+     * @param options Options of the first load and of every reload (copied), the source map and the statistics of
+     * options are filled by the thread of watcher.
+     */
+    Watcher(const char* filename, Snapshot& snapshot, Listener* listener = NULL, std::size_t debounce = 100,
+            const LoadOptions& options = LoadOptions());
+    ~Watcher();
+
+    /**
+     * @brief Add a file (like a included file) which reload the config when it changes.
+     *
+     * @param filename A filename.
+     */
+    void watch(const char* filename);
+
+    /**
+     * @brief Load and publish the config then start the thread of watcher.
+     *
+     * @throw LoadException if the first load or the watch failed.
+     */
+    void start();
+
+    /**
+     * @brief Stop the thread of watcher.
+     */
+    void stop();
+
+  private:
+    Watcher(const Watcher&);
+    Watcher& operator=(const Watcher&);
+
+    struct Thread;
+
+    void closeFds();
+    void reload();
+    void run();
+    bool isWatched(int wd, const char* name) const;
+    static void* s_run(void* watcher);
+
+    std::string filename_;
+    std::list<std::string> filenames_;
+    Snapshot& snapshot_;
+    Listener* listener_;
+    std::size_t debounce_;
+    LoadOptions options_;
+    int inotifyFd_;
+    int stopFds_[2];
+    // basenames of watched files by watch descriptor of their directory
+    std::map<int, std::list<std::string> > watches_;
+    Thread* thread_;
+    bool running_;
+};
+
+/**
+ * @brief Compiled path of a value which keeps the node of the bound dict.
+ * The path is resolved only at the bind of a new dict or of a new version of snapshot,
+ * the next reads are a pointer dereference.
+ */
+class Accessor {
+  public:
+    /**
+     * @brief Construct a new Accessor object on the root.
+     */
+    Accessor();
+
+    /**
+     * @brief Construct a new Accessor object from a path like `foo.bar[0]."baz.qux"`.
+     *
+     * @param path A path of keys separated by dot, with the array indexes in brackets
+     * and the keys with special characters in quotes.
+     * @throw std::invalid_argument if the path is not valid.
+     */
+    explicit Accessor(const char* path);
+
+    /**
+     * @brief Resolve the path in @p dict.
+     * The dict must be alive and not modified while the accessor is used.
+     *
+     * @param dict A dict.
+     * @return const blet::Dict* The node of path or NULL if not found.
+     */
+    const blet::Dict* bind(const blet::Dict& dict);
+
+    /**
+     * @brief Resolve the path in @p dict without keep the node.
+     *
+     * @param dict A dict.
+     * @return const blet::Dict* The node of path or NULL if not found.
+     */
+    const blet::Dict* find(const blet::Dict& dict) const;
+
+    /**
+     * @brief Resolve the path in the dict of @p guard only if its version changed since the last bind.
+     *
+     * @param guard A guard of snapshot.
+     * @return const blet::Dict* The node of path or NULL if not found.
+     */
+    const blet::Dict* bind(const Snapshot::Guard& guard);
+
+    /**
+     * @brief Get the node of the last bind.
+     *
+     * @return const blet::Dict* The node of path or NULL if not found.
+     */
+    const blet::Dict* get() const {
+        return node_;
+    }
+
+    /**
+     * @brief Get the node of the last bind.
+     *
+     * @return const blet::Dict& The node of path.
+     * @throw std::out_of_range if the node is not found.
+     */
+    const blet::Dict& operator*() const;
+
+    /**
+     * @brief Get the node of the last bind.
+     *
+     * @return const blet::Dict* The node of path.
+     * @throw std::out_of_range if the node is not found.
+     */
+    const blet::Dict* operator->() const {
+        return &operator*();
+    }
+
+    /**
+     * @brief Get the source path.
+     *
+     * @return const std::string& The path.
+     */
+    const std::string& path() const {
+        return path_;
+    }
+
+    /**
+     * @brief Append a key to @p path with the syntax of accessor paths.
+     * The key is quoted if it is empty or contains a special character.
+     *
+     * @param path A path of accessor.
+     * @param key A key.
+     */
+    static void appendKey(std::string& path, const std::string& key);
+
+    /**
+     * @brief Append an index to @p path with the syntax of accessor paths.
+     *
+     * @param path A path of accessor.
+     * @param index A index of array.
+     */
+    static void appendIndex(std::string& path, std::size_t index);
+
+  private:
+    friend class SourceMap;
+    friend class SharedDocument;
+
+    struct Segment {
+        std::string key;
+        std::size_t index;
+        bool isIndex;
+    };
+
+    std::string path_;
+    std::vector<Segment> segments_;
+    const blet::Dict* node_;
+    const blet::Dict* root_;
+    unsigned long version_;
+};
+
+/**
+ * @brief Compile a path of value.
+ *
+ * @param path A path like `foo.bar[0]."baz.qux"`.
+ * @return Accessor The accessor of path.
+ * @throw std::invalid_argument if the path is not valid.
+ */
+inline Accessor compile(const char* path) {
+    return Accessor(path);
+}
+
+/**
+ * @brief Path of value with its segments stored in place, the lookups do not allocate.
+ * The keys are not copied: the strings of keys must live while the path is used.
+ * The keys are looked up with the buffer by thread of find, a const path can be shared by threads.
+ */
+class Path {
+  public:
+    enum {
+        MAX_SEGMENTS = 8
+    };
+
+    Path() :
+        size_(0) {}
+
+    /**
+     * @brief Add a key segment.
+     *
+     * @throw std::length_error if the path has already MAX_SEGMENTS segments.
+     */
+    Path& operator[](const char* key) {
+        return this->key(key, ::strlen(key));
+    }
+
+    /**
+     * @brief Add a key segment.
+     *
+     * @throw std::length_error if the path has already MAX_SEGMENTS segments.
+     */
+    Path& operator[](const std::string& key) {
+        return this->key(key.data(), key.size());
+    }
+
+    /**
+     * @brief Add a index segment.
+     *
+     * @throw std::length_error if the path has already MAX_SEGMENTS segments.
+     */
+    Path& operator[](std::size_t index);
+
+    /**
+     * @brief Add a index segment.
+     *
+     * @throw std::length_error if the path has already MAX_SEGMENTS segments.
+     */
+    Path& operator[](int index) {
+        return operator[](static_cast<std::size_t>(index));
+    }
+
+    /**
+     * @brief Add a key segment from a data and its size.
+     *
+     * @throw std::length_error if the path has already MAX_SEGMENTS segments.
+     */
+    Path& key(const char* data, std::size_t size);
+
+    /**
+     * @brief Get the number of segments.
+     */
+    std::size_t size() const {
+        return size_;
+    }
+
+    /**
+     * @brief Resolve the path in @p dict.
+     *
+     * @param dict A dict.
+     * @return const blet::Dict* The node of path or NULL if not found.
+     */
+    const blet::Dict* find(const blet::Dict& dict) const;
+
+    /**
+     * @brief Check if the path exists in @p dict.
+     */
+    bool contains(const blet::Dict& dict) const {
+        return find(dict) != NULL;
+    }
+
+    /**
+     * @brief Get the node of path in @p dict.
+     *
+     * @throw std::out_of_range if the path is not found.
+     */
+    const blet::Dict& at(const blet::Dict& dict) const;
+
+  private:
+    struct Segment {
+        // NULL for a index segment
+        const char* key;
+        std::size_t size;
+        std::size_t index;
+    };
+
+    Segment segments_[MAX_SEGMENTS];
+    std::size_t size_;
+};
+
+/**
+ * @brief Find the member @p key of the object @p dict.
+ * The key is copied in a buffer by thread reused between the lookups
+ * in place of a temporary std::string.
+ *
+ * @param dict A dict.
+ * @param key Data of key.
+ * @param size Size of key.
+ * @return const blet::Dict* The member or NULL if @p dict is not a object or has not @p key.
+ */
+const blet::Dict* find(const blet::Dict& dict, const char* key, std::size_t size);
+
+/**
+ * @brief Find the member @p key of the object @p dict.
+ *
+ * @return blet::Dict* The member or NULL if @p dict is not a object or has not @p key.
+ */
+inline blet::Dict* find(blet::Dict& dict, const char* key, std::size_t size) {
+    return const_cast<blet::Dict*>(find(static_cast<const blet::Dict&>(dict), key, size));
+}
+
+/**
+ * @brief Get the member @p key of the object @p dict.
+ *
+ * @throw std::out_of_range if @p dict is not a object or has not @p key.
+ */
+inline const blet::Dict& at(const blet::Dict& dict, const char* key, std::size_t size) {
+    const blet::Dict* member = find(dict, key, size);
+    if (member == NULL) {
+        throw std::out_of_range("Key not found");
+    }
+    return *member;
+}
+
+/**
+ * @brief Get the member @p key of the object @p dict.
+ *
+ * @throw std::out_of_range if @p dict is not a object or has not @p key.
+ */
+inline blet::Dict& at(blet::Dict& dict, const char* key, std::size_t size) {
+    return const_cast<blet::Dict&>(at(static_cast<const blet::Dict&>(dict), key, size));
+}
+
+/**
+ * @brief Check if the object @p dict has the member @p key.
+ */
+inline bool contains(const blet::Dict& dict, const char* key, std::size_t size) {
+    return find(dict, key, size) != NULL;
+}
+
+inline const blet::Dict* find(const blet::Dict& dict, const char* key) {
+    return find(dict, key, ::strlen(key));
+}
+
+inline blet::Dict* find(blet::Dict& dict, const char* key) {
+    return find(dict, key, ::strlen(key));
+}
+
+inline const blet::Dict& at(const blet::Dict& dict, const char* key) {
+    return at(dict, key, ::strlen(key));
+}
+
+inline blet::Dict& at(blet::Dict& dict, const char* key) {
+    return at(dict, key, ::strlen(key));
+}
+
+inline bool contains(const blet::Dict& dict, const char* key) {
+    return contains(dict, key, ::strlen(key));
+}
+
+#if __cplusplus >= 201703L
+inline const blet::Dict* find(const blet::Dict& dict, std::string_view key) {
+    return find(dict, key.data(), key.size());
+}
+
+inline blet::Dict* find(blet::Dict& dict, std::string_view key) {
+    return find(dict, key.data(), key.size());
+}
+
+inline const blet::Dict& at(const blet::Dict& dict, std::string_view key) {
+    return at(dict, key.data(), key.size());
+}
+
+inline blet::Dict& at(blet::Dict& dict, std::string_view key) {
+    return at(dict, key.data(), key.size());
+}
+
+inline bool contains(const blet::Dict& dict, std::string_view key) {
+    return contains(dict, key.data(), key.size());
+}
+#endif
+
+/**
+ * @brief Read-only config in a POSIX shared memory with a position independent layout.
+ * One process creates the document from a dict, the other processes map it
+ * and read its values in place: the nodes use offsets and not pointers.
+ */
+class SharedDocument {
+  public:
+    /**
+     * @brief Read-only value of a mapped document.
+     * The value is valid while its document is open.
+     */
+    class Value {
+      public:
+        /**
+         * @brief Construct a new null Value object.
+         */
+        Value();
+
+        blet::Dict::EType getType() const;
+
+        bool isNull() const {
+            return getType() == blet::Dict::NULL_TYPE;
+        }
+        bool isBoolean() const {
+            return getType() == blet::Dict::BOOLEAN_TYPE;
+        }
+        bool isNumber() const {
+            return getType() == blet::Dict::NUMBER_TYPE;
+        }
+        bool isString() const {
+            return getType() == blet::Dict::STRING_TYPE;
+        }
+        bool isArray() const {
+            return getType() == blet::Dict::ARRAY_TYPE;
+        }
+        bool isObject() const {
+            return getType() == blet::Dict::OBJECT_TYPE;
+        }
+
+        /**
+         * @throw std::invalid_argument if the value is not a boolean.
+         */
+        bool getBoolean() const;
+
+        /**
+         * @throw std::invalid_argument if the value is not a number.
+         */
+        double getNumber() const;
+
+        /**
+         * @brief Get the string in the shared memory (null terminated).
+         *
+         * @throw std::invalid_argument if the value is not a string.
+         */
+        const char* c_str() const;
+
+        /**
+         * @throw std::invalid_argument if the value is not a string.
+         */
+        std::string getString() const;
+
+        /**
+         * @brief Get the length of string or the number of elements of array or object.
+         *
+         * @return std::size_t The size (0 for the other types).
+         */
+        std::size_t size() const;
+
+        /**
+         * @brief Get the element of array.
+         *
+         * @throw std::out_of_range if the value is not a array or the index is out of range.
+         */
+        Value operator[](std::size_t index) const;
+
+        /**
+         * @brief Get the member of object (binary search).
+         *
+         * @throw std::out_of_range if the value is not a object or the key is not found.
+         */
+        Value operator[](const std::string& key) const;
+
+        /**
+         * @brief Check if the value is a object with @p key.
+         */
+        bool contains(const std::string& key) const;
+
+        /**
+         * @brief Get the key of member at @p index (in the order of keys).
+         *
+         * @throw std::out_of_range if the value is not a object or the index is out of range.
+         */
+        std::string key(std::size_t index) const;
+
+        /**
+         * @brief Get the value of member at @p index (in the order of keys).
+         *
+         * @throw std::out_of_range if the value is not a object or the index is out of range.
+         */
+        Value value(std::size_t index) const;
+
+        /**
+         * @brief Copy the value in a new dict.
+         *
+         * @return blet::Dict The copy.
+         */
+        blet::Dict toDict() const;
+
+      private:
+        friend class SharedDocument;
+
+        Value(const char* base, const void* node);
+
+        const void* member(const std::string& key) const;
+
+        const char* base_;
+        const void* node_;
+    };
+
+    SharedDocument();
+    ~SharedDocument();
+
+    /**
+     * @brief Create (or replace) the shared memory @p name with the content of @p dict.
+     * The header is written at the end, a document opened during the creation is not valid.
+     *
+     * @param name Name of shared memory like `/myconf`.
+     * @param dict A dict.
+     * @param mode Permissions of shared memory.
+     * @throw LoadException if the shared memory can not be created.
+     */
+    static void create(const char* name, const blet::Dict& dict, unsigned int mode = 0644);
+
+    /**
+     * @brief Remove the name of shared memory, the opened documents stay valid.
+     *
+     * @param name Name of shared memory.
+     */
+    static void unlink(const char* name);
+
+    /**
+     * @brief Map a shared memory in read-only.
+     *
+     * @param name Name of shared memory.
+     * @throw LoadException if the shared memory can not be mapped or is not a valid document.
+     */
+    void open(const char* name);
+
+    /**
+     * @brief Unmap the shared memory.
+     */
+    void close();
+
+    bool isOpen() const {
+        return data_ != NULL;
+    }
+
+    /**
+     * @brief Get the size of mapped memory.
+     *
+     * @return std::size_t Size in bytes.
+     */
+    std::size_t size() const {
+        return size_;
+    }
+
+    /**
+     * @brief Get the root value.
+     *
+     * @return Value The root (null if the document is not open).
+     */
+    Value root() const;
+
+    /**
+     * @brief Resolve the path of @p accessor in the document.
+     *
+     * @param accessor A accessor.
+     * @param value The value found.
+     * @return true if the path is found.
+     */
+    bool find(const Accessor& accessor, Value& value) const;
+
+  private:
+    SharedDocument(const SharedDocument&);
+    SharedDocument& operator=(const SharedDocument&);
+
+    const char* data_;
+    std::size_t size_;
+};
+
+template<typename T>
+class Binding;
+
+namespace binding {
+
+inline bool convert(const blet::Dict& node, blet::Dict& value, std::string& /*path*/, std::string& /*error*/) {
+    value = node;
+    return true;
+}
+
+inline bool convert(const blet::Dict& node, bool& value, std::string& /*path*/, std::string& error) {
+    if (!node.isBoolean()) {
+        error = std::string("is not a boolean (is ") + blet::Dict::typeToStr(node.getType()) + ")";
+        return false;
+    }
+    value = node.getValue().getBoolean();
+    return true;
+}
+
+inline bool convert(const blet::Dict& node, std::string& value, std::string& /*path*/, std::string& error) {
+    if (!node.isString()) {
+        error = std::string("is not a string (is ") + blet::Dict::typeToStr(node.getType()) + ")";
+        return false;
+    }
+    value = node.getValue().getString();
+    return true;
+}
+
+template<typename U>
+inline bool convert(const blet::Dict& node, U& value, std::string& /*path*/, std::string& error) {
+    if (!node.isNumber()) {
+        error = std::string("is not a number (is ") + blet::Dict::typeToStr(node.getType()) + ")";
+        return false;
+    }
+    blet::Dict::number_t number = node.getValue().getNumber();
+    if (std::numeric_limits<U>::is_integer) {
+        if (std::floor(number) != number) {
+            error = "is not a integer";
+            return false;
+        }
+        // the max of 64 bits is rounded up as a double, compare with the exclusive bound 2^digits
+        if (number < static_cast<blet::Dict::number_t>(std::numeric_limits<U>::min()) ||
+            number >= std::ldexp(1.0, std::numeric_limits<U>::digits)) {
+            error = "is out of range";
+            return false;
+        }
+    }
+    value = static_cast<U>(number);
+    return true;
+}
+
+template<typename U>
+inline bool convert(const blet::Dict& node, std::vector<U>& value, std::string& path, std::string& error) {
+    if (!node.isArray()) {
+        error = std::string("is not a array (is ") + blet::Dict::typeToStr(node.getType()) + ")";
+        return false;
+    }
+    const blet::Dict::array_t& array = node.getValue().getArray();
+    std::vector<U> values(array.size());
+    for (std::size_t i = 0; i < array.size(); ++i) {
+        std::string elementPath = path;
+        Accessor::appendIndex(elementPath, i);
+        if (!convert(array[i], values[i], elementPath, error)) {
+            // the error is located on the invalid element
+            path.swap(elementPath);
+            return false;
+        }
+    }
+    value.swap(values);
+    return true;
+}
+
+inline LoadException error(const std::string& path, const std::string& message, const SourceMap* sourceMap) {
+    if (sourceMap == NULL) {
+        return LoadException("", path + ": " + message);
+    }
+    return sourceMap->locate(path, path + ": " + message);
+}
+
+template<typename T>
+class FieldBase {
+  public:
+    FieldBase(const char* path, bool required) :
+        accessor_(path),
+        required_(required) {}
+
+    virtual ~FieldBase() {}
+
+    void bind(const blet::Dict& dict, T& object, std::vector<LoadException>& errors, const SourceMap* sourceMap,
+              const std::string& prefix) const {
+        std::string path = prefix;
+        if (!accessor_.path().empty()) {
+            if (!path.empty() && accessor_.path()[0] != '[') {
+                path += '.';
+            }
+            path += accessor_.path();
+        }
+        const blet::Dict* node = accessor_.find(dict);
+        if (node == NULL) {
+            if (required_) {
+                errors.push_back(error(path, "is not found", NULL));
+            }
+            return;
+        }
+        bindNode(*node, object, errors, sourceMap, path);
+    }
+
+  protected:
+    virtual void bindNode(const blet::Dict& node, T& object, std::vector<LoadException>& errors,
+                          const SourceMap* sourceMap, const std::string& path) const = 0;
+
+    Accessor accessor_;
+    bool required_;
+};
+
+template<typename T, typename U>
+class Field : public FieldBase<T> {
+  public:
+    Field(const char* path, U T::*member, bool required) :
+        FieldBase<T>(path, required),
+        member_(member) {}
+
+  protected:
+    void bindNode(const blet::Dict& node, T& object, std::vector<LoadException>& errors, const SourceMap* sourceMap,
+                  const std::string& path) const {
+        std::string errorPath = path;
+        std::string message;
+        if (!convert(node, object.*member_, errorPath, message)) {
+            errors.push_back(error(errorPath, message, sourceMap));
+        }
+    }
+
+  private:
+    U T::*member_;
+};
+
+template<typename T, typename U>
+class NestedField : public FieldBase<T> {
+  public:
+    NestedField(const char* path, U T::*member, const Binding<U>& binding, bool required) :
+        FieldBase<T>(path, required),
+        member_(member),
+        binding_(binding) {}
+
+  protected:
+    void bindNode(const blet::Dict& node, T& object, std::vector<LoadException>& errors, const SourceMap* sourceMap,
+                  const std::string& path) const {
+        binding_.bind(node, object.*member_, errors, sourceMap, path);
+    }
+
+  private:
+    U T::*member_;
+    const Binding<U>& binding_;
+};
+
+} // namespace binding
+
+/**
+ * @brief Declarative binding of conf paths to the members of a struct.
+ *
+ * @code
+ * blet::conf::Binding<Server> binding;
+ * binding.field("server.host", &Server::host).field("server.port", &Server::port);
+ * Server server;
+ * binding.bind(conf, server);
+ * @endcode
+ *
+ * @tparam T Type of struct.
+ */
+template<typename T>
+class Binding {
+  public:
+    Binding() :
+        fields_() {}
+
+    ~Binding() {
+        for (std::size_t i = 0; i < fields_.size(); ++i) {
+            delete fields_[i];
+        }
+    }
+
+    /**
+     * @brief Add a field of a boolean, number, string, dict or vector of them.
+     *
+     * @param path A path of value (see Accessor).
+     * @param member A pointer to member of struct.
+     * @param required If false, a not found path keeps the value of member.
+     * @return Binding& This binding.
+     * @throw std::invalid_argument if the path is not valid.
+     */
+    template<typename U>
+    Binding& field(const char* path, U T::*member, bool required = true) {
+        fields_.push_back(NULL);
+        fields_.back() = new binding::Field<T, U>(path, member, required);
+        return *this;
+    }
+
+    /**
+     * @brief Add a field of a struct with its binding.
+     *
+     * @param path A path of object (see Accessor).
+     * @param member A pointer to member of struct.
+     * @param binding The binding of member, must live as long as this binding.
+     * @param required If false, a not found path keeps the value of member.
+     * @return Binding& This binding.
+     * @throw std::invalid_argument if the path is not valid.
+     */
+    template<typename U>
+    Binding& field(const char* path, U T::*member, const Binding<U>& binding, bool required = true) {
+        fields_.push_back(NULL);
+        fields_.back() = new binding::NestedField<T, U>(path, member, binding, required);
+        return *this;
+    }
+
+    /**
+     * @brief Fill @p object from @p dict in one pass of the fields.
+     *
+     * @param dict A dict.
+     * @param object A object.
+     * @throw BindException with all the errors of fields.
+     */
+    void bind(const blet::Dict& dict, T& object) const {
+        std::vector<LoadException> errors;
+        bind(dict, object, errors);
+        if (!errors.empty()) {
+            throw BindException(errors);
+        }
+    }
+
+    /**
+     * @brief Fill @p object from @p dict with the source locations in the errors.
+     *
+     * @param dict A dict.
+     * @param object A object.
+     * @param sourceMap The source map of load of @p dict.
+     * @throw BindException with all the errors of fields.
+     */
+    void bind(const blet::Dict& dict, T& object, const SourceMap& sourceMap) const {
+        std::vector<LoadException> errors;
+        bind(dict, object, errors, &sourceMap);
+        if (!errors.empty()) {
+            throw BindException(errors);
+        }
+    }
+
+    /**
+     * @brief Fill @p object from @p dict and append the errors in @p errors.
+     *
+     * @param dict A dict.
+     * @param object A object.
+     * @param errors The errors of fields.
+     * @param sourceMap If not NULL, the source map of load of @p dict.
+     * @param prefix The path of @p dict in the source map.
+     */
+    void bind(const blet::Dict& dict, T& object, std::vector<LoadException>& errors,
+              const SourceMap* sourceMap = NULL, const std::string& prefix = std::string()) const {
+        for (std::size_t i = 0; i < fields_.size(); ++i) {
+            fields_[i]->bind(dict, object, errors, sourceMap, prefix);
+        }
+    }
+
+  private:
+    Binding(const Binding&);
+    Binding& operator=(const Binding&);
+
+    std::vector<binding::FieldBase<T>*> fields_;
+};
+
+/**
+ * @brief Rules of validation of a dict, compiled once and checked in one traversal.
+ *
+ * @code
+ * blet::conf::Schema schema;
+ * schema.key("server").required().type(blet::Dict::OBJECT_TYPE);
+ * schema.key("server").key("port").required().range(1, 65535);
+ * schema.key("tenants").key("*").key("name").pattern("^[a-z]+$");
+ * std::vector<blet::conf::LoadException> violations = schema.validate(conf);
+ * @endcode
+ */
+class Schema {
+  public:
+    Schema();
+    ~Schema();
+
+    /**
+     * @brief Get the rule of a key of object, created if not exists.
+     *
+     * @param key A key or "*" for the keys without rule.
+     * @return Schema& The rule of key.
+     */
+    Schema& key(const std::string& key);
+
+    /**
+     * @brief Get the rule of the elements of array.
+     *
+     * @return Schema& The rule of elements.
+     */
+    Schema& items();
+
+    /**
+     * @brief The key of this rule must exist in its object.
+     *
+     * @param required The key is required.
+     * @return Schema& This rule.
+     */
+    Schema& required(bool required = true);
+
+    /**
+     * @brief The value must be of @p type.
+     *
+     * @param type A type of dict.
+     * @return Schema& This rule.
+     */
+    Schema& type(blet::Dict::EType type);
+
+    /**
+     * @brief A number value must be between @p min and @p max.
+     *
+     * @param min The minimum.
+     * @param max The maximum.
+     * @return Schema& This rule.
+     */
+    Schema& range(double min, double max);
+
+    /**
+     * @brief A string value must match the POSIX extended regular expression @p pattern.
+     *
+     * @param pattern A regular expression.
+     * @return Schema& This rule.
+     * @throw std::invalid_argument if the pattern is not valid.
+     */
+    Schema& pattern(const char* pattern);
+
+    /**
+     * @brief A array value must have between @p min and @p max elements.
+     *
+     * @param min The minimum of elements.
+     * @param max The maximum of elements.
+     * @return Schema& This rule.
+     */
+    Schema& size(std::size_t min, std::size_t max);
+
+    /**
+     * @brief Check @p dict in one traversal.
+     *
+     * @param dict A dict.
+     * @return std::vector<LoadException> The violations of rules with the path of value in message.
+     */
+    std::vector<LoadException> validate(const blet::Dict& dict) const;
+
+    /**
+     * @brief Check @p dict in one traversal with the source locations in the violations.
+     *
+     * @param dict A dict.
+     * @param sourceMap The source map of load of @p dict.
+     * @return std::vector<LoadException> The violations of rules with the path of value in message.
+     */
+    std::vector<LoadException> validate(const blet::Dict& dict, const SourceMap& sourceMap) const;
+
+  private:
+    struct Pattern;
+    class Validator;
+
+    Schema(const Schema&);
+    Schema& operator=(const Schema&);
+
+    enum EFlag {
+        REQUIRED_FLAG = 1 << 0,
+        TYPE_FLAG = 1 << 1,
+        RANGE_FLAG = 1 << 2,
+        SIZE_FLAG = 1 << 3
+    };
+
+    unsigned int flags_;
+    blet::Dict::EType type_;
+    double min_;
+    double max_;
+    std::size_t minSize_;
+    std::size_t maxSize_;
+    Pattern* pattern_;
+    std::map<std::string, Schema*> keys_;
+    Schema* wildcard_;
+    Schema* items_;
+};
 
 } // namespace conf
 
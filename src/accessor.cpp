@@ -0,0 +1,193 @@
+/**
+ * accessor.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <limits>  // std::numeric_limits
+#include <sstream> // std::ostringstream
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+static void s_throwInvalidPath(const std::string& path, std::size_t index) {
+    std::ostringstream oss("");
+    oss << "Invalid path \"" << path << "\" at column " << index + 1;
+    throw std::invalid_argument(oss.str());
+}
+
+static bool s_isSpecial(char c) {
+    return c == '.' || c == '[' || c == ']' || c == '"' || c == '\'';
+}
+
+Accessor::Accessor() :
+    path_(),
+    segments_(),
+    node_(NULL),
+    root_(NULL),
+    version_(0) {}
+
+Accessor::Accessor(const char* path) :
+    path_(path),
+    segments_(),
+    node_(NULL),
+    root_(NULL),
+    version_(0) {
+    std::size_t i = 0;
+    while (i < path_.size()) {
+        Segment segment;
+        segment.index = 0;
+        segment.isIndex = false;
+        if (path_[i] == '[') {
+            // index
+            std::size_t start = ++i;
+            while (i < path_.size() && path_[i] >= '0' && path_[i] <= '9') {
+                std::size_t digit = path_[i] - '0';
+                if (segment.index > (std::numeric_limits<std::size_t>::max() - digit) / 10) {
+                    // index overflow
+                    s_throwInvalidPath(path_, i);
+                }
+                segment.index = segment.index * 10 + digit;
+                ++i;
+            }
+            if (i == start || i >= path_.size() || path_[i] != ']') {
+                s_throwInvalidPath(path_, i);
+            }
+            ++i;
+            segment.isIndex = true;
+        }
+        else {
+            if (!segments_.empty()) {
+                if (path_[i] != '.') {
+                    s_throwInvalidPath(path_, i);
+                }
+                ++i;
+            }
+            if (i < path_.size() && (path_[i] == '"' || path_[i] == '\'')) {
+                // quoted key
+                char quote = path_[i++];
+                while (i < path_.size() && path_[i] != quote) {
+                    if (path_[i] == '\\' && i + 1 < path_.size()) {
+                        ++i;
+                    }
+                    segment.key += path_[i++];
+                }
+                if (i >= path_.size()) {
+                    s_throwInvalidPath(path_, i);
+                }
+                ++i;
+            }
+            else {
+                std::size_t start = i;
+                while (i < path_.size() && !s_isSpecial(path_[i])) {
+                    ++i;
+                }
+                if (i == start) {
+                    s_throwInvalidPath(path_, i);
+                }
+                segment.key.assign(path_, start, i - start);
+            }
+        }
+        segments_.push_back(segment);
+    }
+}
+
+const blet::Dict* Accessor::bind(const blet::Dict& dict) {
+    root_ = &dict;
+    version_ = 0;
+    node_ = find(dict);
+    return node_;
+}
+
+const blet::Dict* Accessor::find(const blet::Dict& dict) const {
+    const blet::Dict* node = &dict;
+    for (std::size_t i = 0; i < segments_.size() && node != NULL; ++i) {
+        if (segments_[i].isIndex) {
+            if (node->isArray() && segments_[i].index < node->getValue().getArray().size()) {
+                node = &node->getValue().getArray()[segments_[i].index];
+            }
+            else {
+                node = NULL;
+            }
+        }
+        else {
+            if (node->isObject()) {
+                blet::Dict::object_t::const_iterator cit = node->getValue().getObject().find(segments_[i].key);
+                node = cit != node->getValue().getObject().end() ? &cit->second : NULL;
+            }
+            else {
+                node = NULL;
+            }
+        }
+    }
+    return node;
+}
+
+const blet::Dict* Accessor::bind(const Snapshot::Guard& guard) {
+    if (root_ != &*guard || version_ != guard.version()) {
+        bind(*guard);
+        version_ = guard.version();
+    }
+    return node_;
+}
+
+const blet::Dict& Accessor::operator*() const {
+    if (node_ == NULL) {
+        throw std::out_of_range("Path \"" + path_ + "\" not found");
+    }
+    return *node_;
+}
+
+void Accessor::appendKey(std::string& path, const std::string& key) {
+    if (!path.empty()) {
+        path += '.';
+    }
+    bool quoted = key.empty();
+    for (std::size_t i = 0; i < key.size() && !quoted; ++i) {
+        quoted = s_isSpecial(key[i]);
+    }
+    if (!quoted) {
+        path += key;
+        return;
+    }
+    path += '"';
+    for (std::size_t i = 0; i < key.size(); ++i) {
+        if (key[i] == '"' || key[i] == '\\') {
+            path += '\\';
+        }
+        path += key[i];
+    }
+    path += '"';
+}
+
+void Accessor::appendIndex(std::string& path, std::size_t index) {
+    std::ostringstream oss("");
+    oss << '[' << index << ']';
+    path += oss.str();
+}
+
+} // namespace conf
+
+} // namespace blet
@@ -23,8 +23,22 @@
  * SOFTWARE.
  */
 
-#include <iomanip> // std::setprecision
-#include <limits>  // std::numeric_limits
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iomanip>   // std::setprecision
+#include <limits>    // std::numeric_limits
+#include <new>       // std::bad_alloc
+#include <streambuf> // std::streambuf
+#include <vector>    // std::vector
 
 #include "blet/conf.h"
 
@@ -42,93 +56,212 @@ namespace conf {
 // .................................
 // -----------------------------------------------------------------------------
 
+/**
+ * @brief Indent policy of dumper with newline and indentation.
+ */
+struct PrettyIndent {};
+
+/**
+ * @brief Indent policy of dumper without newline and indentation.
+ */
+struct CompactIndent {};
+
+/**
+ * @brief Get the time of a monotonic clock.
+ *
+ * @return double Time in seconds.
+ */
+static double s_clock() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Stats policy of dumper without statistics, all the calls are removed by the compiler.
+ */
+struct NoDumpStats {
+    NoDumpStats(DumpStats* /*stats*/) {}
+
+    void node(blet::Dict::EType /*type*/) {}
+    void quotedKey() {}
+    void escapedString() {}
+    double numberStart() {
+        return 0.0;
+    }
+    void numberEnd(double /*start*/) {}
+};
+
+/**
+ * @brief Stats policy of dumper which fills a DumpStats.
+ */
+struct CountDumpStats {
+    CountDumpStats(DumpStats* stats) :
+        stats_(*stats) {}
+
+    void node(blet::Dict::EType type) {
+        ++stats_.nodes[type];
+    }
+    void quotedKey() {
+        ++stats_.quotedKeys;
+    }
+    void escapedString() {
+        ++stats_.escapedStrings;
+    }
+    double numberStart() {
+        return s_clock();
+    }
+    void numberEnd(double start) {
+        stats_.numberTime += s_clock() - start;
+    }
+
+    DumpStats& stats_;
+};
+
+template<typename IndentPolicy, typename StatsPolicy = NoDumpStats>
 class Dumper {
   public:
-    Dumper(std::ostream& os, std::size_t indent, char indentCharacter) :
+    Dumper(std::ostream& os, std::size_t indent, char indentCharacter, DumpStats* stats = NULL) :
         os_(os),
         indent_(indent),
         indentCharacter_(indentCharacter),
-        indentIndex_(0) {}
+        indentIndex_(0),
+        stats_(stats) {}
 
     ~Dumper() {}
 
     void stringEscape(const std::string& str) {
+        const char* data = str.data();
+        std::size_t start = 0;
         for (std::size_t i = 0; i < str.size(); ++i) {
-            switch (str[i]) {
-                case '\a':
-                    os_ << '\\' << 'a';
-                    break;
-                case '\b':
-                    os_ << '\\' << 'b';
-                    break;
-                case '\f':
-                    os_ << '\\' << 'f';
-                    break;
-                case '\n':
-                    os_ << '\\' << 'n';
-                    break;
-                case '\r':
-                    os_ << '\\' << 'r';
-                    break;
-                case '\t':
-                    os_ << '\\' << 't';
-                    break;
-                case '\v':
-                    os_ << '\\' << 'v';
-                    break;
-                case '\'':
-                    os_ << '\\' << '\'';
-                    break;
-                case '"':
-                    os_ << '\\' << '"';
-                    break;
-                case '\\':
-                    os_ << '\\' << '\\';
-                    break;
-                default:
-                    os_ << str[i];
-                    break;
+            char escape = escapeCharacter(data[i]);
+            if (escape != '\0') {
+                // write the block of characters without escape
+                os_.write(data + start, i - start);
+                os_.put('\\');
+                os_.put(escape);
+                start = i + 1;
             }
         }
+        if (start > 0) {
+            stats_.escapedString();
+        }
+        os_.write(data + start, str.size() - start);
     }
 
-    void newlineDump(const blet::Dict& dict) {
-        if (indent_ != 0 && ((dict.isArray() && !dict.getValue().getArray().empty()) ||
-                             (dict.isObject() && !dict.getValue().getObject().empty()))) {
-            os_ << '\n';
-        }
+    void newlineDump() {
+        newlineDump(IndentPolicy());
     }
 
     void indentDump() {
-        if (indent_ != 0) {
-            os_ << std::string(indent_ * indentIndex_, indentCharacter_);
+        indentDump(IndentPolicy());
+    }
+
+    void assignDump() {
+        assignDump(IndentPolicy());
+    }
+
+    void keyDump(const std::string& key) {
+        if (forceKeyString(key)) {
+            stats_.quotedKey();
+            os_.put('"');
+            stringEscape(key);
+            os_.put('"');
+        }
+        else {
+            stringEscape(key);
         }
     }
 
     void nullDump() {
-        os_ << "null";
+        stats_.node(blet::Dict::NULL_TYPE);
+        os_.write("null", 4);
     }
 
     void numberDump(const blet::Dict& dict) {
+        stats_.node(blet::Dict::NUMBER_TYPE);
+        double start = stats_.numberStart();
         os_ << dict.getValue().getNumber();
+        stats_.numberEnd(start);
     }
 
     void booleanDump(const blet::Dict& dict) {
+        stats_.node(blet::Dict::BOOLEAN_TYPE);
         if (dict.getValue().getBoolean()) {
-            os_ << "true";
+            os_.write("true", 4);
         }
         else {
-            os_ << "false";
+            os_.write("false", 5);
         }
     }
 
     void stringDump(const blet::Dict& dict) {
-        os_ << '"';
+        stats_.node(blet::Dict::STRING_TYPE);
+        os_.put('"');
         stringEscape(dict.getValue().getString());
-        os_ << '"';
+        os_.put('"');
     }
 
   protected:
+    void newlineDump(PrettyIndent /*policy*/) {
+        os_.put('\n');
+    }
+
+    void newlineDump(CompactIndent /*policy*/) {}
+
+    void indentDump(PrettyIndent /*policy*/) {
+        std::size_t size = indent_ * indentIndex_;
+        if (indentation_.size() < size) {
+            indentation_.resize(size, indentCharacter_);
+        }
+        os_.write(indentation_.data(), size);
+    }
+
+    void indentDump(CompactIndent /*policy*/) {}
+
+    void assignDump(PrettyIndent /*policy*/) {
+        os_.write(" = ", 3);
+    }
+
+    void assignDump(CompactIndent /*policy*/) {
+        os_.put('=');
+    }
+
+    static char escapeCharacter(char c) {
+        char ret = '\0';
+        switch (c) {
+            case '\a':
+                ret = 'a';
+                break;
+            case '\b':
+                ret = 'b';
+                break;
+            case '\f':
+                ret = 'f';
+                break;
+            case '\n':
+                ret = 'n';
+                break;
+            case '\r':
+                ret = 'r';
+                break;
+            case '\t':
+                ret = 't';
+                break;
+            case '\v':
+                ret = 'v';
+                break;
+            case '\'':
+            case '"':
+            case '\\':
+                ret = c;
+                break;
+            default:
+                break;
+        }
+        return ret;
+    }
+
     static bool forceKeyString(const std::string& str) {
         bool ret = false;
         if (str.empty()) {
@@ -169,6 +302,8 @@ class Dumper {
     std::size_t indent_;
     char indentCharacter_;
     std::size_t indentIndex_;
+    std::string indentation_;
+    StatsPolicy stats_;
 };
 
 // -----------------------------------------------------------------------------
@@ -181,10 +316,11 @@ class Dumper {
 // .........................................................................
 // -----------------------------------------------------------------------------
 
-class JsonDumper : public Dumper {
+template<typename IndentPolicy, typename StatsPolicy = NoDumpStats>
+class JsonDumper : public Dumper<IndentPolicy, StatsPolicy> {
   public:
-    JsonDumper(std::ostream& os, std::size_t indent, char indentCharacter) :
-        Dumper(os, indent, indentCharacter) {}
+    JsonDumper(std::ostream& os, std::size_t indent, char indentCharacter, DumpStats* stats = NULL) :
+        Dumper<IndentPolicy, StatsPolicy>(os, indent, indentCharacter, stats) {}
 
     ~JsonDumper() {}
 
@@ -197,14 +333,8 @@ class JsonDumper : public Dumper {
                 jsonDumpType(dict);
                 break;
             case blet::Dict::ARRAY_TYPE:
-                os_ << "\"\"";
-                if (indent_ > 0) {
-                    os_ << ' ';
-                }
-                os_ << '=';
-                if (indent_ > 0) {
-                    os_ << ' ';
-                }
+                this->os_.write("\"\"", 2);
+                this->assignDump();
                 jsonDumpArray(dict);
                 break;
             case blet::Dict::OBJECT_TYPE:
@@ -214,45 +344,37 @@ class JsonDumper : public Dumper {
     }
 
     void jsonDumpObjectFirst(const blet::Dict& dict) {
+        this->stats_.node(blet::Dict::OBJECT_TYPE);
         for (blet::Dict::object_t::const_iterator cit = dict.getValue().getObject().begin();
              cit != dict.getValue().getObject().end(); ++cit) {
             if (cit != dict.getValue().getObject().begin()) {
-                os_ << '\n';
-            }
-            // key
-            indentDump();
-            if (forceKeyString(cit->first)) {
-                os_ << '"';
-                stringEscape(cit->first);
-                os_ << '"';
-            }
-            else {
-                stringEscape(cit->first);
-            }
-            if (indent_ > 0) {
-                os_ << ' ';
-            }
-            os_ << '=';
-            if (indent_ > 0) {
-                os_ << ' ';
+                this->os_.put('\n');
             }
-            jsonDumpType(cit->second);
+            jsonDumpMember(cit->first, cit->second);
         }
     }
 
+    void jsonDumpMember(const std::string& key, const blet::Dict& dict) {
+        // key
+        this->indentDump();
+        this->keyDump(key);
+        this->assignDump();
+        jsonDumpType(dict);
+    }
+
     void jsonDumpType(const blet::Dict& dict) {
         switch (dict.getType()) {
             case blet::Dict::NULL_TYPE:
-                nullDump();
+                this->nullDump();
                 break;
             case blet::Dict::BOOLEAN_TYPE:
-                booleanDump(dict);
+                this->booleanDump(dict);
                 break;
             case blet::Dict::NUMBER_TYPE:
-                numberDump(dict);
+                this->numberDump(dict);
                 break;
             case blet::Dict::STRING_TYPE:
-                stringDump(dict);
+                this->stringDump(dict);
                 break;
             case blet::Dict::ARRAY_TYPE:
                 jsonDumpArray(dict);
@@ -264,66 +386,55 @@ class JsonDumper : public Dumper {
     }
 
     void jsonDumpArray(const blet::Dict& dict) {
+        this->stats_.node(blet::Dict::ARRAY_TYPE);
         if (dict.getValue().getArray().empty()) {
-            os_ << "[]";
+            this->os_.write("[]", 2);
         }
         else {
-            os_ << '[';
-            newlineDump(dict);
-            ++indentIndex_;
+            this->os_.put('[');
+            this->newlineDump();
+            ++this->indentIndex_;
             for (std::size_t i = 0; i < dict.getValue().getArray().size(); ++i) {
                 if (i > 0) {
-                    os_ << ',';
-                    newlineDump(dict);
+                    this->os_.put(',');
+                    this->newlineDump();
                 }
                 // value
-                indentDump();
+                this->indentDump();
                 jsonDumpType(dict.getValue().getArray()[i]);
             }
-            --indentIndex_;
-            newlineDump(dict);
-            indentDump();
-            os_ << ']';
+            --this->indentIndex_;
+            this->newlineDump();
+            this->indentDump();
+            this->os_.put(']');
         }
     }
 
     void jsonDumpObject(const blet::Dict& dict) {
+        this->stats_.node(blet::Dict::OBJECT_TYPE);
         if (dict.getValue().getObject().empty()) {
-            os_ << "{}";
+            this->os_.write("{}", 2);
         }
         else {
-            os_ << '{';
-            newlineDump(dict);
-            ++indentIndex_;
+            this->os_.put('{');
+            this->newlineDump();
+            ++this->indentIndex_;
             for (blet::Dict::object_t::const_iterator cit = dict.getValue().getObject().begin();
                  cit != dict.getValue().getObject().end(); ++cit) {
                 if (cit != dict.getValue().getObject().begin()) {
-                    os_ << ',';
-                    newlineDump(dict);
+                    this->os_.put(',');
+                    this->newlineDump();
                 }
                 // key
-                indentDump();
-                if (forceKeyString(cit->first)) {
-                    os_ << '"';
-                    stringEscape(cit->first);
-                    os_ << '"';
-                }
-                else {
-                    stringEscape(cit->first);
-                }
-                if (indent_ > 0) {
-                    os_ << ' ';
-                }
-                os_ << '=';
-                if (indent_ > 0) {
-                    os_ << ' ';
-                }
+                this->indentDump();
+                this->keyDump(cit->first);
+                this->assignDump();
                 jsonDumpType(cit->second);
             }
-            --indentIndex_;
-            newlineDump(dict);
-            indentDump();
-            os_ << '}';
+            --this->indentIndex_;
+            this->newlineDump();
+            this->indentDump();
+            this->os_.put('}');
         }
     }
 };
@@ -338,10 +449,11 @@ class JsonDumper : public Dumper {
 // .........................................................................
 // -----------------------------------------------------------------------------
 
-class ConfDumper : public JsonDumper {
+template<typename IndentPolicy, typename StatsPolicy = NoDumpStats>
+class ConfDumper : public JsonDumper<IndentPolicy, StatsPolicy> {
   public:
-    ConfDumper(std::ostream& os, std::size_t indent, char indentCharacter) :
-        JsonDumper(os, indent, indentCharacter),
+    ConfDumper(std::ostream& os, std::size_t indent, char indentCharacter, DumpStats* stats = NULL) :
+        JsonDumper<IndentPolicy, StatsPolicy>(os, indent, indentCharacter, stats),
         sectionIndex_(0) {}
 
     ~ConfDumper() {}
@@ -349,16 +461,16 @@ class ConfDumper : public JsonDumper {
     void confDumpType(const blet::Dict& dict) {
         switch (dict.getType()) {
             case blet::Dict::NULL_TYPE:
-                nullDump();
+                this->nullDump();
                 break;
             case blet::Dict::BOOLEAN_TYPE:
-                booleanDump(dict);
+                this->booleanDump(dict);
                 break;
             case blet::Dict::NUMBER_TYPE:
-                numberDump(dict);
+                this->numberDump(dict);
                 break;
             case blet::Dict::STRING_TYPE:
-                stringDump(dict);
+                this->stringDump(dict);
                 break;
             case blet::Dict::ARRAY_TYPE:
                 confDumpArray("", dict);
@@ -370,52 +482,27 @@ class ConfDumper : public JsonDumper {
     }
 
     void confDumpArray(const std::string& key, const blet::Dict& dict) {
+        this->stats_.node(blet::Dict::ARRAY_TYPE);
         if (dict.getValue().getArray().empty()) {
             // key
-            indentDump();
-            if (forceKeyString(key)) {
-                os_ << '"';
-                stringEscape(key);
-                os_ << '"';
-            }
-            else {
-                stringEscape(key);
-            }
+            this->indentDump();
+            this->keyDump(key);
             // value operator
-            if (indent_ > 0) {
-                os_ << ' ';
-            }
-            os_ << '=';
-            if (indent_ > 0) {
-                os_ << ' ';
-            }
-            os_ << "[]";
+            this->assignDump();
+            this->os_.write("[]", 2);
         }
         else {
             for (std::size_t i = 0; i < dict.getValue().getArray().size(); ++i) {
                 if (i > 0) {
-                    os_ << '\n';
+                    this->os_.put('\n');
                 }
                 // key
-                indentDump();
-                if (forceKeyString(key)) {
-                    os_ << '"';
-                    stringEscape(key);
-                    os_ << '"';
-                }
-                else {
-                    stringEscape(key);
-                }
+                this->indentDump();
+                this->keyDump(key);
                 // array operator
-                os_ << "[]";
+                this->os_.write("[]", 2);
                 // value operator
-                if (indent_ > 0) {
-                    os_ << ' ';
-                }
-                os_ << '=';
-                if (indent_ > 0) {
-                    os_ << ' ';
-                }
+                this->assignDump();
                 // value
                 switch (dict.getValue().getArray()[i].getType()) {
                     case blet::Dict::NULL_TYPE:
@@ -425,10 +512,10 @@ class ConfDumper : public JsonDumper {
                         confDumpType(dict.getValue().getArray()[i]);
                         break;
                     case blet::Dict::ARRAY_TYPE:
-                        jsonDumpArray(dict.getValue().getArray()[i]);
+                        this->jsonDumpArray(dict.getValue().getArray()[i]);
                         break;
                     case blet::Dict::OBJECT_TYPE:
-                        jsonDumpObject(dict.getValue().getArray()[i]);
+                        this->jsonDumpObject(dict.getValue().getArray()[i]);
                         break;
                 }
             }
@@ -436,8 +523,29 @@ class ConfDumper : public JsonDumper {
     }
 
     void confDumpObject(const blet::Dict& dict) {
-        int index = 0;
+        this->stats_.node(blet::Dict::OBJECT_TYPE);
         ++sectionIndex_;
+        std::size_t index = confDumpValues(dict);
+        for (blet::Dict::object_t::const_iterator cit = dict.getValue().getObject().begin();
+             cit != dict.getValue().getObject().end(); ++cit) {
+            if (cit->second.getType() == blet::Dict::OBJECT_TYPE) {
+                if (index > 0) {
+                    this->os_.put('\n');
+                }
+                ++index;
+                confDumpSection(cit->first, cit->second);
+            }
+        }
+        --sectionIndex_;
+    }
+
+    /**
+     * @brief Dump the members of object which are not a object.
+     *
+     * @return std::size_t number of members dumped.
+     */
+    std::size_t confDumpValues(const blet::Dict& dict) {
+        std::size_t index = 0;
         for (blet::Dict::object_t::const_iterator cit = dict.getValue().getObject().begin();
              cit != dict.getValue().getObject().end(); ++cit) {
             switch (cit->second.getType()) {
@@ -446,30 +554,17 @@ class ConfDumper : public JsonDumper {
                 case blet::Dict::NUMBER_TYPE:
                 case blet::Dict::STRING_TYPE:
                     if (index > 0) {
-                        os_ << '\n';
+                        this->os_.put('\n');
                     }
                     ++index;
-                    indentDump();
-                    if (forceKeyString(cit->first)) {
-                        os_ << '"';
-                        stringEscape(cit->first);
-                        os_ << '"';
-                    }
-                    else {
-                        stringEscape(cit->first);
-                    }
-                    if (indent_ > 0) {
-                        os_ << ' ';
-                    }
-                    os_ << '=';
-                    if (indent_ > 0) {
-                        os_ << ' ';
-                    }
+                    this->indentDump();
+                    this->keyDump(cit->first);
+                    this->assignDump();
                     confDumpType(cit->second);
                     break;
                 case blet::Dict::ARRAY_TYPE:
                     if (index > 0) {
-                        os_ << '\n';
+                        this->os_.put('\n');
                     }
                     ++index;
                     confDumpArray(cit->first, cit->second);
@@ -478,53 +573,420 @@ class ConfDumper : public JsonDumper {
                     break;
             }
         }
-        for (blet::Dict::object_t::const_iterator cit = dict.getValue().getObject().begin();
-             cit != dict.getValue().getObject().end(); ++cit) {
-            if (cit->second.getType() == blet::Dict::OBJECT_TYPE) {
-                if (index > 0) {
-                    os_ << '\n';
-                }
-                ++index;
-                if (cit->second.getValue().getObject().empty()) {
-                    if (forceKeyString(cit->first)) {
-                        os_ << '"';
-                        stringEscape(cit->first);
-                        os_ << '"';
+        return index;
+    }
+
+    void confDumpSection(const std::string& key, const blet::Dict& dict) {
+        if (dict.getValue().getObject().empty()) {
+            this->stats_.node(blet::Dict::OBJECT_TYPE);
+            this->keyDump(key);
+            this->assignDump();
+            this->os_.write("{}", 2);
+        }
+        else {
+            // new section
+            this->os_ << std::string(sectionIndex_, '[');
+            this->keyDump(key);
+            this->os_ << std::string(sectionIndex_, ']');
+            this->os_.put('\n');
+            confDumpType(dict);
+        }
+    }
+
+    /**
+     * @brief Dump a object member of the root object as a first level section.
+     */
+    void confDumpRootSection(const std::string& key, const blet::Dict& dict) {
+        ++sectionIndex_;
+        confDumpSection(key, dict);
+        --sectionIndex_;
+    }
+
+  private:
+    std::size_t sectionIndex_;
+};
+
+/**
+ * @brief Render the first level members of a object in separate buffers from a pool of threads and write them in
+ * the order of the sequential dumper.
+ */
+template<typename IndentPolicy>
+class ParallelDumper {
+  public:
+    ParallelDumper(const blet::Dict& dict, std::ostream& os, std::size_t indent, char indentCharacter,
+                   enum EDumpStyle style) :
+        dict_(dict),
+        os_(os),
+        indent_(indent),
+        indentCharacter_(indentCharacter),
+        style_(style),
+        format_(""),
+        next_(0) {
+        format_.copyfmt(os_);
+        // the workers must not flush the tied stream of the caller
+        format_.tie(NULL);
+        for (blet::Dict::object_t::const_iterator cit = dict_.getValue().getObject().begin();
+             cit != dict_.getValue().getObject().end(); ++cit) {
+            if (isTask(cit->second)) {
+                members_.push_back(&(*cit));
+            }
+        }
+        outputs_.resize(members_.size());
+        failures_.resize(members_.size(), false);
+        pthread_mutex_init(&mutex_, NULL);
+    }
+
+    ~ParallelDumper() {
+        pthread_mutex_destroy(&mutex_);
+    }
+
+    void run(std::size_t threads) {
+        if (threads > members_.size()) {
+            threads = members_.size();
+        }
+        std::vector<pthread_t> workers;
+        for (std::size_t i = 1; i < threads; ++i) {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, &s_work, this) != 0) {
+                break; // the current thread take the remaining tasks
+            }
+            workers.push_back(thread);
+        }
+        work();
+        for (std::size_t i = 0; i < workers.size(); ++i) {
+            pthread_join(workers[i], NULL);
+        }
+    }
+
+    void write() {
+        std::size_t task = 0;
+        switch (style_) {
+            case CONF_STYLE: {
+                ConfDumper<IndentPolicy> conf(os_, indent_, indentCharacter_);
+                std::size_t index = conf.confDumpValues(dict_);
+                for (blet::Dict::object_t::const_iterator cit = dict_.getValue().getObject().begin();
+                     cit != dict_.getValue().getObject().end(); ++cit) {
+                    if (cit->second.getType() == blet::Dict::OBJECT_TYPE) {
+                        if (index > 0) {
+                            os_.put('\n');
+                        }
+                        ++index;
+                        if (isTask(cit->second)) {
+                            writeTask(task++);
+                        }
+                        else {
+                            conf.confDumpRootSection(cit->first, cit->second);
+                        }
                     }
-                    else {
-                        stringEscape(cit->first);
+                }
+                break;
+            }
+            case JSON_STYLE: {
+                JsonDumper<IndentPolicy> json(os_, indent_, indentCharacter_);
+                for (blet::Dict::object_t::const_iterator cit = dict_.getValue().getObject().begin();
+                     cit != dict_.getValue().getObject().end(); ++cit) {
+                    if (cit != dict_.getValue().getObject().begin()) {
+                        os_.put('\n');
                     }
-                    if (indent_ > 0) {
-                        os_ << ' ';
+                    if (isTask(cit->second)) {
+                        writeTask(task++);
                     }
-                    os_ << '=';
-                    if (indent_ > 0) {
-                        os_ << ' ';
+                    else {
+                        json.jsonDumpMember(cit->first, cit->second);
                     }
-                    os_ << "{}";
+                }
+                break;
+            }
+        }
+    }
+
+  private:
+    bool isTask(const blet::Dict& dict) const {
+        bool task = dict.isObject() && !dict.getValue().getObject().empty();
+        if (style_ == JSON_STYLE) {
+            task = task || (dict.isArray() && !dict.getValue().getArray().empty());
+        }
+        return task;
+    }
+
+    void render(std::ostream& os, const blet::Dict::object_t::value_type& member) {
+        switch (style_) {
+            case CONF_STYLE: {
+                ConfDumper<IndentPolicy> conf(os, indent_, indentCharacter_);
+                conf.confDumpRootSection(member.first, member.second);
+                break;
+            }
+            case JSON_STYLE: {
+                JsonDumper<IndentPolicy> json(os, indent_, indentCharacter_);
+                json.jsonDumpMember(member.first, member.second);
+                break;
+            }
+        }
+    }
+
+    void writeTask(std::size_t task) {
+        if (failures_[task]) {
+            // render again in the caller thread for throw the error
+            render(os_, *members_[task]);
+        }
+        else {
+            os_.write(outputs_[task].data(), outputs_[task].size());
+        }
+    }
+
+    void work() {
+        while (true) {
+            pthread_mutex_lock(&mutex_);
+            std::size_t task = next_++;
+            pthread_mutex_unlock(&mutex_);
+            if (task >= members_.size()) {
+                break;
+            }
+            try {
+                std::ostringstream oss("");
+                oss.copyfmt(format_);
+                render(oss, *members_[task]);
+                if (oss) {
+                    outputs_[task] = oss.str();
                 }
                 else {
-                    // new section
-                    os_ << std::string(sectionIndex_, '[');
-                    if (forceKeyString(cit->first)) {
-                        os_ << '"';
-                        stringEscape(cit->first);
-                        os_ << '"';
-                    }
-                    else {
-                        stringEscape(cit->first);
-                    }
-                    os_ << std::string(sectionIndex_, ']');
-                    os_ << '\n';
-                    confDumpType(cit->second);
+                    failures_[task] = true;
                 }
             }
+            catch (...) {
+                failures_[task] = true;
+            }
         }
-        --sectionIndex_;
+    }
+
+    static void* s_work(void* self) {
+        static_cast<ParallelDumper*>(self)->work();
+        return NULL;
+    }
+
+    const blet::Dict& dict_;
+    std::ostream& os_;
+    std::size_t indent_;
+    char indentCharacter_;
+    enum EDumpStyle style_;
+    std::ostringstream format_;
+    std::vector<const blet::Dict::object_t::value_type*> members_;
+    std::vector<std::string> outputs_;
+    std::vector<char> failures_;
+    pthread_mutex_t mutex_;
+    std::size_t next_;
+};
+
+/**
+ * @brief Stream buffer at the end of a string.
+ * Write directly in the storage of the string, the string is truncated at the written size at destruction.
+ */
+class StringStreamBuf : public std::streambuf {
+  public:
+    StringStreamBuf(std::string& str, DumpStats* stats = NULL) :
+        std::streambuf(),
+        str_(str),
+        stats_(stats) {
+        std::size_t size = str_.size();
+        if (str_.capacity() > size) {
+            // use the unused capacity
+            str_.resize(str_.capacity());
+        }
+        else {
+            str_.resize(size * 2 + s_minSize);
+            if (stats_ != NULL) {
+                ++stats_->reallocations;
+            }
+        }
+        setp(&str_[0] + size, &str_[0] + str_.size());
+    }
+
+    ~StringStreamBuf() {
+        str_.resize(pptr() - &str_[0]);
+    }
+
+  protected:
+    int_type overflow(int_type c) {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            grow(1);
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) {
+        if (n > epptr() - pptr()) {
+            grow(static_cast<std::size_t>(n));
+        }
+        ::memcpy(pptr(), s, n);
+        setp(pptr() + n, epptr());
+        return n;
     }
 
   private:
-    std::size_t sectionIndex_;
+    void grow(std::size_t size) {
+        std::size_t used = pptr() - &str_[0];
+        std::size_t newSize = str_.size() * 2;
+        if (newSize < used + size) {
+            newSize = used + size;
+        }
+        str_.resize(newSize);
+        setp(&str_[0] + used, &str_[0] + str_.size());
+        if (stats_ != NULL) {
+            ++stats_->reallocations;
+        }
+    }
+
+    static const std::size_t s_minSize = 256;
+
+    std::string& str_;
+    DumpStats* stats_;
+};
+
+/**
+ * @brief Stream buffer of file descriptor.
+ * Write the pending buffer and the large blocks together with writev.
+ */
+class FdStreamBuf : public std::streambuf {
+  public:
+    FdStreamBuf(int fd, DumpStats* stats = NULL) :
+        std::streambuf(),
+        fd_(fd),
+        buffer_(NULL),
+        stats_(stats) {
+        void* buffer = NULL;
+        if (::posix_memalign(&buffer, s_alignment, s_bufferSize) != 0) {
+            throw std::bad_alloc();
+        }
+        buffer_ = static_cast<char*>(buffer);
+        setp(buffer_, buffer_ + s_bufferSize);
+    }
+
+    ~FdStreamBuf() {
+        ::free(buffer_);
+    }
+
+  protected:
+    int_type overflow(int_type c) {
+        char character = traits_type::to_char_type(c);
+        struct iovec iov[2];
+        std::size_t count = 0;
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            count = 1;
+            iov[1].iov_base = &character;
+            iov[1].iov_len = 1;
+        }
+        if (!writeBuffer(iov, count)) {
+            return traits_type::eof();
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) {
+        if (n <= epptr() - pptr()) {
+            ::memcpy(pptr(), s, n);
+            pbump(static_cast<int>(n));
+            return n;
+        }
+        // large block write without copy
+        struct iovec iov[2];
+        iov[1].iov_base = const_cast<char*>(s);
+        iov[1].iov_len = n;
+        if (!writeBuffer(iov, 1)) {
+            return 0;
+        }
+        return n;
+    }
+
+    int sync() {
+        struct iovec iov[1];
+        if (!writeBuffer(iov, 0)) {
+            return -1;
+        }
+        return 0;
+    }
+
+  private:
+    /**
+     * @brief Write the pending buffer at iov[0] followed by the @p count others iov.
+     */
+    bool writeBuffer(struct iovec* iov, std::size_t count) {
+        iov[0].iov_base = pbase();
+        iov[0].iov_len = pptr() - pbase();
+        ++count;
+        setp(buffer_, buffer_ + s_bufferSize);
+        while (count > 0) {
+            ssize_t ret = ::writev(fd_, iov, static_cast<int>(count));
+            if (stats_ != NULL) {
+                ++stats_->flushes;
+            }
+            if (ret < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            // jump the written iov
+            std::size_t written = static_cast<std::size_t>(ret);
+            while (count > 0 && written >= iov[0].iov_len) {
+                written -= iov[0].iov_len;
+                ++iov;
+                --count;
+            }
+            if (count > 0) {
+                iov[0].iov_base = static_cast<char*>(iov[0].iov_base) + written;
+                iov[0].iov_len -= written;
+            }
+        }
+        return true;
+    }
+
+    static const std::size_t s_alignment = 4096;
+    static const std::size_t s_bufferSize = 1024 * 1024;
+
+    int fd_;
+    char* buffer_;
+    DumpStats* stats_;
+};
+
+/**
+ * @brief Stream buffer which counts the written bytes and forwards them to a other buffer.
+ */
+class CountStreamBuf : public std::streambuf {
+  public:
+    CountStreamBuf(std::streambuf* buffer, std::size_t& bytes) :
+        std::streambuf(),
+        buffer_(buffer),
+        bytes_(bytes) {}
+
+    ~CountStreamBuf() {}
+
+  protected:
+    int_type overflow(int_type c) {
+        int_type ret = traits_type::not_eof(c);
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            ret = buffer_->sputc(traits_type::to_char_type(c));
+            if (!traits_type::eq_int_type(ret, traits_type::eof())) {
+                ++bytes_;
+            }
+        }
+        return ret;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) {
+        std::streamsize written = buffer_->sputn(s, n);
+        bytes_ += static_cast<std::size_t>(written);
+        return written;
+    }
+
+    int sync() {
+        return buffer_->pubsync();
+    }
+
+  private:
+    std::streambuf* buffer_;
+    std::size_t& bytes_;
 };
 
 /**
@@ -548,25 +1010,170 @@ struct ConfDumpInfo {
     std::size_t index;
 };
 
-void dump(const blet::Dict& dict, std::ostream& os, std::size_t indent, char indentCharacter, enum EDumpStyle style) {
-    os << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+template<typename IndentPolicy, typename StatsPolicy>
+static void s_dump(const blet::Dict& dict, std::ostream& os, std::size_t indent, char indentCharacter,
+                   enum EDumpStyle style, DumpStats* stats) {
     switch (style) {
         case CONF_STYLE: {
-            ConfDumper conf(os, indent, indentCharacter);
+            ConfDumper<IndentPolicy, StatsPolicy> conf(os, indent, indentCharacter, stats);
             conf.confDumpType(dict);
             break;
         }
         case JSON_STYLE: {
-            JsonDumper conf(os, indent, indentCharacter);
+            JsonDumper<IndentPolicy, StatsPolicy> conf(os, indent, indentCharacter, stats);
             conf.jsonDumpTypeFirst(dict);
             break;
         }
     }
 }
 
-std::string dump(const blet::Dict& dict, std::size_t indent, char indentCharacter, enum EDumpStyle style) {
+/**
+ * @brief Dump in a stream without clear the statistics (filled by the buffers of output).
+ */
+static void s_dumpStream(const blet::Dict& dict, std::ostream& os, std::size_t indent, char indentCharacter,
+                         enum EDumpStyle style, DumpStats* stats) {
+    os << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+    if (stats == NULL) {
+        if (indent == 0) {
+            // minified output without any formatting branch
+            s_dump<CompactIndent, NoDumpStats>(dict, os, indent, indentCharacter, style, stats);
+        }
+        else {
+            s_dump<PrettyIndent, NoDumpStats>(dict, os, indent, indentCharacter, style, stats);
+        }
+    }
+    else {
+        CountStreamBuf buffer(os.rdbuf(), stats->bytes);
+        std::ostream countStream(&buffer);
+        countStream.copyfmt(os);
+        double start = s_clock();
+        if (indent == 0) {
+            s_dump<CompactIndent, CountDumpStats>(dict, countStream, indent, indentCharacter, style, stats);
+        }
+        else {
+            s_dump<PrettyIndent, CountDumpStats>(dict, countStream, indent, indentCharacter, style, stats);
+        }
+        stats->structureTime += s_clock() - start - stats->numberTime;
+        os.setstate(countStream.rdstate());
+    }
+}
+
+void dump(const blet::Dict& dict, std::ostream& os, std::size_t indent, char indentCharacter, enum EDumpStyle style,
+          DumpStats* stats) {
+    if (stats != NULL) {
+        stats->clear();
+    }
+    s_dumpStream(dict, os, indent, indentCharacter, style, stats);
+}
+
+std::string dump(const blet::Dict& dict, std::size_t indent, char indentCharacter, enum EDumpStyle style,
+                 DumpStats* stats) {
+    std::string str;
+    dump(dict, str, indent, indentCharacter, style, stats);
+    return str;
+}
+
+void dump(const blet::Dict& dict, std::string& str, std::size_t indent, char indentCharacter, enum EDumpStyle style,
+          DumpStats* stats) {
+    if (stats != NULL) {
+        stats->clear();
+    }
+    StringStreamBuf buffer(str, stats);
+    std::ostream os(&buffer);
+    s_dumpStream(dict, os, indent, indentCharacter, style, stats);
+}
+
+void dumpFd(const blet::Dict& dict, int fd, std::size_t indent, char indentCharacter, enum EDumpStyle style,
+            DumpStats* stats) {
+    if (stats != NULL) {
+        stats->clear();
+    }
+    FdStreamBuf buffer(fd, stats);
+    std::ostream os(&buffer);
+    s_dumpStream(dict, os, indent, indentCharacter, style, stats);
+    os.flush();
+    if (!os) {
+        throw DumpException("", "Write failed");
+    }
+}
+
+void dumpFile(const blet::Dict& dict, const char* filename, std::size_t indent, char indentCharacter,
+              enum EDumpStyle style, DumpStats* stats) {
+    // open a new temporary file near of filename
+    std::string tmpFilename;
+    int fd = -1;
+    for (std::size_t i = 0; fd < 0; ++i) {
+        std::ostringstream oss("");
+        oss << filename << '.' << ::getpid() << '.' << i << ".tmp";
+        tmpFilename = oss.str();
+        fd = ::open(tmpFilename.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        if (fd < 0 && errno != EEXIST) {
+            throw DumpException(filename, "Open file failed");
+        }
+    }
+    try {
+        // keep the permissions of the replaced file
+        struct stat fileStat;
+        if (::stat(filename, &fileStat) == 0) {
+            ::fchmod(fd, fileStat.st_mode & 07777);
+        }
+        bool written = true;
+        try {
+            dumpFd(dict, fd, indent, indentCharacter, style, stats);
+        }
+        catch (const DumpException&) {
+            written = false;
+        }
+        written = written && ::fsync(fd) == 0;
+        written = ::close(fd) == 0 && written;
+        fd = -1;
+        if (!written) {
+            throw DumpException(filename, "Write failed");
+        }
+        if (::rename(tmpFilename.c_str(), filename) != 0) {
+            throw DumpException(filename, "Rename file failed");
+        }
+    }
+    catch (...) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        ::unlink(tmpFilename.c_str());
+        throw;
+    }
+}
+
+template<typename IndentPolicy>
+static void s_parallelDump(const blet::Dict& dict, std::ostream& os, std::size_t indent, char indentCharacter,
+                           enum EDumpStyle style, std::size_t threads) {
+    ParallelDumper<IndentPolicy> parallel(dict, os, indent, indentCharacter, style);
+    parallel.run(threads);
+    parallel.write();
+}
+
+void parallelDump(const blet::Dict& dict, std::ostream& os, std::size_t indent, char indentCharacter,
+                  enum EDumpStyle style, std::size_t threads) {
+    if (threads == 0) {
+        long onlineProcessors = ::sysconf(_SC_NPROCESSORS_ONLN);
+        threads = onlineProcessors > 0 ? static_cast<std::size_t>(onlineProcessors) : 1;
+    }
+    if (threads <= 1 || !dict.isObject()) {
+        dump(dict, os, indent, indentCharacter, style);
+        return;
+    }
+    os << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+    if (indent == 0) {
+        s_parallelDump<CompactIndent>(dict, os, indent, indentCharacter, style, threads);
+    }
+    else {
+        s_parallelDump<PrettyIndent>(dict, os, indent, indentCharacter, style, threads);
+    }
+}
+
+std::string parallelDump(const blet::Dict& dict, std::size_t indent, char indentCharacter, enum EDumpStyle style,
+                         std::size_t threads) {
     std::ostringstream oss("");
-    dump(dict, oss, indent, indentCharacter, style);
+    parallelDump(dict, oss, indent, indentCharacter, style, threads);
     return oss.str();
 }
 
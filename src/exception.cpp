@@ -82,6 +82,91 @@ const std::size_t& LoadException::column() const throw() {
     return column_;
 }
 
+DumpException::DumpException(const std::string& filename, const std::string& message) :
+    std::exception(),
+    filename_(filename),
+    message_(message) {
+    std::ostringstream oss("");
+    oss << "Dump ";
+    if (!filename_.empty()) {
+        oss << filename_ << ": ";
+    }
+    oss << '(' << message_ << ")";
+    what_ = oss.str();
+}
+
+DumpException::~DumpException() throw() {}
+
+const char* DumpException::what() const throw() {
+    return what_.c_str();
+}
+
+const std::string& DumpException::filename() const throw() {
+    return filename_;
+}
+
+const std::string& DumpException::message() const throw() {
+    return message_;
+}
+
+MergeException::MergeException(const std::string& path, const std::string& message) :
+    std::exception(),
+    path_(path),
+    message_(message) {
+    std::ostringstream oss("");
+    oss << "Merge ";
+    if (!path_.empty()) {
+        oss << path_ << ": ";
+    }
+    oss << '(' << message_ << ")";
+    what_ = oss.str();
+}
+
+MergeException::~MergeException() throw() {}
+
+const char* MergeException::what() const throw() {
+    return what_.c_str();
+}
+
+const std::string& MergeException::path() const throw() {
+    return path_;
+}
+
+const std::string& MergeException::message() const throw() {
+    return message_;
+}
+
+BindException::BindException(const std::vector<LoadException>& errors) :
+    std::exception(),
+    errors_(errors) {
+    std::ostringstream oss("");
+    oss << "Bind (";
+    for (std::size_t i = 0; i < errors_.size(); ++i) {
+        if (i > 0) {
+            oss << ", ";
+        }
+        if (errors_[i].line() > 0) {
+            if (!errors_[i].filename().empty()) {
+                oss << errors_[i].filename() << ':';
+            }
+            oss << errors_[i].line() << ':' << errors_[i].column() << ' ';
+        }
+        oss << errors_[i].message();
+    }
+    oss << ')';
+    what_ = oss.str();
+}
+
+BindException::~BindException() throw() {}
+
+const char* BindException::what() const throw() {
+    return what_.c_str();
+}
+
+const std::vector<LoadException>& BindException::errors() const throw() {
+    return errors_;
+}
+
 } // namespace conf
 
 } // namespace blet
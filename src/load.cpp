@@ -23,11 +23,19 @@
  * SOFTWARE.
  */
 
+#include <errno.h>
+#include <glob.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
+#include <deque>   // std::deque
 #include <fstream> // std::ifstream
+#include <iomanip> // std::setprecision
+#include <limits>  // std::numeric_limits
+#include <map>     // std::map
 
 #include "blet/conf.h"
 
@@ -35,30 +43,243 @@ namespace blet {
 
 namespace conf {
 
+// parent of the records of first level in the source map
+static const std::size_t s_rootRecord = static_cast<std::size_t>(-1);
+// index of the key records in the source map
+static const std::size_t s_noIndex = static_cast<std::size_t>(-1);
+// first capacity of the loaded arrays
+static const std::size_t s_minArrayCapacity = 8;
+// first number of entries of the section cache
+static const std::size_t s_minSectionCacheSize = 16;
+// first size of the buffer of a not seekable stream
+static const std::size_t s_minReadSize = 4096;
+
+/**
+ * @brief Error function of glob: a missing directory is not matched, the others errors abort.
+ */
+static int s_globError(const char* /*path*/, int error) {
+    return error != ENOENT && error != ENOTDIR;
+}
+
+/**
+ * @brief Append a new null element at the back of array and return it.
+ * The vector of blet::Dict has not move constructor, its growth relocate the
+ * elements by swap for not copy their contents.
+ *
+ * @param array array of dict
+ * @return blet::Dict& new element
+ */
+static blet::Dict& s_pushBack(blet::Dict::array_t& array) {
+    if (array.size() == array.capacity()) {
+        blet::Dict::array_t relocated;
+        relocated.reserve(array.capacity() < s_minArrayCapacity ? s_minArrayCapacity : array.capacity() * 2);
+        relocated.resize(array.size());
+        for (std::size_t i = 0; i < array.size(); ++i) {
+            relocated[i].swap(array[i]);
+        }
+        array.swap(relocated);
+    }
+    array.push_back(blet::Dict());
+    return array.back();
+}
+
+/**
+ * @brief Append a new null element at the back of a null or array dict.
+ */
+static blet::Dict& s_pushBack(blet::Dict& dict) {
+    return s_pushBack(dict.getArray());
+}
+
+/**
+ * @brief Get the time of a monotonic clock.
+ *
+ * @return double Time in seconds.
+ */
+static double s_now() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Count the values and the depth of a loaded dict.
+ */
+static void s_countNodes(const blet::Dict& dict, LoadStats& stats, std::size_t depth) {
+    ++stats.nodes[dict.getType()];
+    if (depth > stats.maxDepth) {
+        stats.maxDepth = depth;
+    }
+    if (dict.isArray()) {
+        const blet::Dict::array_t& array = dict.getValue().getArray();
+        for (std::size_t i = 0; i < array.size(); ++i) {
+            s_countNodes(array[i], stats, depth + 1);
+        }
+    }
+    else if (dict.isObject()) {
+        const blet::Dict::object_t& object = dict.getValue().getObject();
+        for (blet::Dict::object_t::const_iterator cit = object.begin(); cit != object.end(); ++cit) {
+            s_countNodes(cit->second, stats, depth + 1);
+        }
+    }
+}
+
+/**
+ * @brief Get the member @p key of dict like operator[].
+ * The keys of generated or dumped configs are sorted, a key after the last
+ * member is inserted at the end with a hint for not search in the map.
+ *
+ * @param dict null or object dict
+ * @param key key of member
+ * @return blet::Dict& the member
+ */
+static blet::Dict& s_member(blet::Dict& dict, const std::string& key) {
+    if (dict.isObject()) {
+        blet::Dict::object_t& object = dict.getValue().getObject();
+        if (!object.empty() && object.rbegin()->first < key) {
+            return object.insert(object.end(), blet::Dict::object_t::value_type(key, blet::Dict()))->second;
+        }
+    }
+    return dict[key];
+}
+
+/**
+ * @brief Hash table of the opened sections by parent and name.
+ * The reopen of a section costs one probe in place of a search in the map of its parent,
+ * the cache must be cleared when a object which can contain a section is replaced.
+ */
+class SectionCache {
+  public:
+    SectionCache() :
+        entries_(),
+        size_(0) {}
+
+    ~SectionCache() {}
+
+    blet::Dict* find(const blet::Dict* parent, const std::string& name) const {
+        if (size_ == 0) {
+            return NULL;
+        }
+        std::size_t mask = entries_.size() - 1;
+        for (std::size_t i = s_hash(parent, name) & mask; entries_[i].section != NULL; i = (i + 1) & mask) {
+            if (entries_[i].parent == parent && entries_[i].name == name) {
+                return entries_[i].section;
+            }
+        }
+        return NULL;
+    }
+
+    void insert(const blet::Dict* parent, const std::string& name, blet::Dict* section) {
+        // keep a load factor under 1/2
+        if ((size_ + 1) * 2 > entries_.size()) {
+            rehash(entries_.empty() ? s_minSectionCacheSize : entries_.size() * 2);
+        }
+        insertEntry(parent, name, section);
+        ++size_;
+    }
+
+    void clear() {
+        if (size_ > 0) {
+            for (std::size_t i = 0; i < entries_.size(); ++i) {
+                entries_[i].section = NULL;
+            }
+            size_ = 0;
+        }
+    }
+
+  private:
+    struct Entry {
+        Entry() :
+            parent(NULL),
+            name(),
+            section(NULL) {}
+
+        const blet::Dict* parent;
+        std::string name;
+        blet::Dict* section;
+    };
+
+    static std::size_t s_hash(const blet::Dict* parent, const std::string& name) {
+        // FNV-1a of name mixed with the address of parent
+        std::size_t hash = static_cast<std::size_t>(2166136261UL) ^ reinterpret_cast<std::size_t>(parent);
+        for (std::size_t i = 0; i < name.size(); ++i) {
+            hash ^= static_cast<unsigned char>(name[i]);
+            hash *= static_cast<std::size_t>(16777619UL);
+        }
+        return hash ^ (hash >> 16);
+    }
+
+    void insertEntry(const blet::Dict* parent, const std::string& name, blet::Dict* section) {
+        std::size_t mask = entries_.size() - 1;
+        std::size_t i = s_hash(parent, name) & mask;
+        while (entries_[i].section != NULL) {
+            i = (i + 1) & mask;
+        }
+        entries_[i].parent = parent;
+        entries_[i].name = name;
+        entries_[i].section = section;
+    }
+
+    void rehash(std::size_t size) {
+        std::vector<Entry> entries(size);
+        entries_.swap(entries);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].section != NULL) {
+                insertEntry(entries[i].parent, entries[i].name, entries[i].section);
+            }
+        }
+    }
+
+    std::vector<Entry> entries_;
+    std::size_t size_;
+};
+
 class StringReader {
   public:
-    StringReader(std::istream& stream) :
+    StringReader(std::istream& stream, MemoryResource& memoryResource, LoadStats* stats) :
         stream_(stream),
+        memoryResource_(memoryResource),
+        data_(NULL),
+        size_(0),
+        capacity_(0),
         pos_(0),
         line_(1),
         posColumn_(0) {
-        stream_.seekg(0, stream_.end);
-        std::size_t streamLength = stream_.tellg();
-        stream_.seekg(0, stream_.beg);
-        std::vector<char> vBuffer(streamLength);
-        stream_.read(vBuffer.data(), vBuffer.size());
-        str_.append(vBuffer.begin(), vBuffer.end());
+        double start = stats != NULL ? s_now() : 0.0;
+        std::streampos end = -1;
+        if (stream_.seekg(0, stream_.end)) {
+            end = stream_.tellg();
+        }
+        if (end != std::streampos(-1) && stream_.seekg(0, stream_.beg)) {
+            // read directly in the buffer of resource with a end character
+            capacity_ = static_cast<std::size_t>(end) + 1;
+            data_ = static_cast<char*>(memoryResource_.allocate(capacity_));
+            stream_.read(data_, capacity_ - 1);
+            size_ = stream_.gcount();
+        }
+        else {
+            // not seekable stream
+            stream_.clear();
+            readUnsized();
+        }
+        data_[size_] = '\0';
+        if (stats != NULL) {
+            stats->readTime += s_now() - start;
+            stats->bytes += size_;
+            ++stats->files;
+        }
     }
 
-    ~StringReader() {}
+    ~StringReader() {
+        memoryResource_.deallocate(data_, capacity_);
+    }
 
     template<std::size_t Size>
     bool operator==(const char (&str)[Size]) {
-        return !str_.compare(pos_, Size - 1, str, Size - 1);
+        return pos_ + Size - 1 <= size_ && ::memcmp(data_ + pos_, str, Size - 1) == 0;
     }
 
     void operator++() {
-        if (str_[pos_] == '\n') {
+        if (data_[pos_] == '\n') {
             posColumn_ = pos_ + 1;
             ++line_;
         }
@@ -72,11 +293,11 @@ class StringReader {
     }
 
     const char& operator[](std::size_t index) {
-        return str_[pos_ + index];
+        return data_[pos_ + index];
     }
 
     std::string substr(std::size_t start, std::size_t end) {
-        return str_.substr(start, end - start);
+        return std::string(data_ + start, end - start);
     }
 
     std::size_t line() {
@@ -91,23 +312,259 @@ class StringReader {
         return pos_;
     }
 
+    const char* data() const {
+        return data_;
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
     std::istream& streamOffset(std::size_t offset) {
         return stream_.seekg(offset, stream_.beg);
     }
 
   private:
+    StringReader(const StringReader&);
+    StringReader& operator=(const StringReader&);
+
+    /**
+     * @brief Read the stream until its end in a growing buffer.
+     */
+    void readUnsized() {
+        capacity_ = s_minReadSize;
+        data_ = static_cast<char*>(memoryResource_.allocate(capacity_));
+        // keep one byte for the end character
+        while (stream_.read(data_ + size_, capacity_ - size_ - 1)) {
+            size_ = capacity_ - 1;
+            char* data = static_cast<char*>(memoryResource_.allocate(capacity_ * 2));
+            ::memcpy(data, data_, size_);
+            memoryResource_.deallocate(data_, capacity_);
+            data_ = data;
+            capacity_ *= 2;
+        }
+        size_ += stream_.gcount();
+        stream_.clear();
+    }
+
     std::istream& stream_;
-    std::string str_;
+    MemoryResource& memoryResource_;
+    char* data_;
+    std::size_t size_;
+    std::size_t capacity_;
     std::size_t pos_;
     std::size_t line_;
     std::size_t posColumn_;
 };
 
+/**
+ * @brief Resolve the references of the strings recorded by the loader.
+ */
+class Interpolator {
+  public:
+    Interpolator(blet::Dict& dict, const SourceMap& sourceMap) :
+        dict_(dict),
+        sourceMap_(sourceMap),
+        pending_(),
+        states_() {}
+
+    ~Interpolator() {}
+
+    void resolve(const std::vector<std::size_t>& records) {
+        // the recorded strings can be overwritten after their record
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            blet::Dict* node = find(records[i]);
+            if (node != NULL && node->isString() && node->getValue().getString().find("${") != std::string::npos) {
+                pending_[node] = records[i];
+            }
+        }
+        for (std::map<blet::Dict*, std::size_t>::iterator it = pending_.begin(); it != pending_.end(); ++it) {
+            resolveNode(it->first, it->second);
+        }
+    }
+
+  private:
+    enum EState {
+        RESOLVING_STATE,
+        RESOLVED_STATE
+    };
+
+    blet::Dict* find(std::size_t record) {
+        std::vector<std::size_t> records;
+        while (record != s_rootRecord) {
+            records.push_back(record);
+            record = sourceMap_.parents_[record];
+        }
+        blet::Dict* node = &dict_;
+        for (std::size_t i = records.size(); i > 0 && node != NULL; --i) {
+            std::size_t index = sourceMap_.indexes_[records[i - 1]];
+            if (index != s_noIndex) {
+                if (node->isArray() && index < node->getValue().getArray().size()) {
+                    node = &(node->getValue().getArray()[index]);
+                }
+                else {
+                    node = NULL;
+                }
+            }
+            else if (node->isObject()) {
+                blet::Dict::object_t::iterator it = node->getValue().getObject().find(sourceMap_.keys_[records[i - 1]]);
+                node = it != node->getValue().getObject().end() ? &(it->second) : NULL;
+            }
+            else {
+                node = NULL;
+            }
+        }
+        return node;
+    }
+
+    void resolveNode(blet::Dict* node, std::size_t record) {
+        std::map<blet::Dict*, EState>::iterator state = states_.find(node);
+        if (state != states_.end()) {
+            if (state->second == RESOLVED_STATE) {
+                return;
+            }
+            throw exception(record, "Interpolation cycle");
+        }
+        states_[node] = RESOLVING_STATE;
+        const std::string value = node->getValue().getString();
+        std::string result;
+        std::size_t i = 0;
+        while (i < value.size()) {
+            if (value.compare(i, 3, "$${") == 0) {
+                result += "${";
+                i += 3;
+            }
+            else if (value.compare(i, 2, "${") == 0) {
+                std::size_t end = value.find('}', i + 2);
+                if (end == std::string::npos) {
+                    throw exception(record, "End of reference");
+                }
+                std::string name = value.substr(i + 2, end - i - 2);
+                const blet::Dict* target = reference(name, record);
+                if (target == NULL) {
+                    const char* env = name.empty() ? NULL : ::getenv(name.c_str());
+                    if (env == NULL) {
+                        throw exception(record, "Reference ${" + name + "} not found");
+                    }
+                    result += env;
+                }
+                else if (i == 0 && end + 1 == value.size()) {
+                    // keep the type of a alone reference
+                    blet::Dict copy(*target);
+                    node->swap(copy);
+                    states_[node] = RESOLVED_STATE;
+                    return;
+                }
+                else if (target->isString()) {
+                    result += target->getValue().getString();
+                }
+                else if (target->isNumber()) {
+                    std::ostringstream oss("");
+                    oss << std::setprecision(std::numeric_limits<blet::Dict::number_t>::digits10 + 1)
+                        << target->getValue().getNumber();
+                    result += oss.str();
+                }
+                else if (target->isBoolean()) {
+                    result += target->getValue().getBoolean() ? "true" : "false";
+                }
+                i = end + 1;
+            }
+            else {
+                result += value[i];
+                ++i;
+            }
+        }
+        *node = result;
+        states_[node] = RESOLVED_STATE;
+    }
+
+    const blet::Dict* reference(const std::string& name, std::size_t record) {
+        blet::Dict* target = NULL;
+        if (!name.empty()) {
+            try {
+                target = const_cast<blet::Dict*>(Accessor(name.c_str()).find(dict_));
+            }
+            catch (const std::invalid_argument&) {
+                // not a path
+            }
+        }
+        if (target != NULL) {
+            if (target->isObject() || target->isArray()) {
+                throw exception(record, "Reference ${" + name + "} is not a value");
+            }
+            // resolve the referenced string before
+            std::map<blet::Dict*, std::size_t>::iterator it = pending_.find(target);
+            if (it != pending_.end()) {
+                resolveNode(target, it->second);
+            }
+        }
+        return target;
+    }
+
+    LoadException exception(std::size_t record, const std::string& message) const {
+        SourceMap::Location location;
+        sourceMap_.location(record, location);
+        return LoadException(location.filename, location.line, location.column, message);
+    }
+
+    blet::Dict& dict_;
+    const SourceMap& sourceMap_;
+    std::map<blet::Dict*, std::size_t> pending_;
+    std::map<blet::Dict*, EState> states_;
+};
+
+/**
+ * @brief Included files shared by the loaders of a load.
+ */
+class IncludeContext {
+  public:
+    struct Fragment {
+        blet::Dict dict;
+        SourceMap* sourceMap;
+        std::vector<std::size_t> interpolations;
+    };
+
+    IncludeContext() :
+        fragments_(),
+        stack_() {}
+
+    ~IncludeContext() {
+        for (std::map<std::string, Fragment>::iterator it = fragments_.begin(); it != fragments_.end(); ++it) {
+            delete it->second.sourceMap;
+        }
+    }
+
+    // parsed fragments by real path
+    std::map<std::string, Fragment> fragments_;
+    // real paths of the files in loading
+    std::vector<std::string> stack_;
+
+  private:
+    IncludeContext(const IncludeContext&);
+    IncludeContext& operator=(const IncludeContext&);
+};
+
 class Loader {
   public:
-    Loader(const std::string& filename, std::istream& stream) :
+    Loader(const std::string& filename, std::istream& stream, const LoadOptions& options,
+           IncludeContext* includeContext = NULL) :
         filename_(filename),
-        reader_(stream) {}
+        reader_(stream, options.memoryResource != NULL ? *options.memoryResource : newDeleteResource(), options.stats),
+        options_(options),
+        stats_(options.stats),
+        ownSourceMap_(),
+        sourceMap_(options.sourceMap == NULL && options.interpolation ? &ownSourceMap_ : options.sourceMap),
+        file_(0),
+        ownIncludeContext_(),
+        includeContext_(includeContext != NULL ? includeContext : &ownIncludeContext_),
+        interpolations_(),
+        arrayBuffers_(),
+        arrayDepth_(0) {
+        if (sourceMap_ != NULL) {
+            sourceMap_->clear();
+            file_ = sourceMap_->addFile(filename_, reader_.data(), reader_.size());
+        }
+    }
 
     ~Loader() {}
 
@@ -118,34 +575,62 @@ class Loader {
     };
 
     void load(blet::Dict& dict) {
+        double start = 0.0;
+        double readTime = 0.0;
+        if (stats_ != NULL) {
+            start = s_now();
+            readTime = stats_->readTime;
+        }
         spaceJump();
         while (reader_[0] != '\0') {
             loadType(dict);
         }
+        // the included files are resolved by the first loader
+        if (!interpolations_.empty() && includeContext_ == &ownIncludeContext_) {
+            Interpolator interpolator(dict, *sourceMap_);
+            interpolator.resolve(interpolations_);
+        }
+        if (stats_ != NULL && includeContext_ == &ownIncludeContext_) {
+            // without the reads of included files
+            stats_->parseTime += s_now() - start - (stats_->readTime - readTime);
+            s_countNodes(dict, *stats_, 0);
+        }
     }
 
     void loadType(blet::Dict& dict) {
         if (reader_[0] == '[') {
             loadSection(dict);
         }
+        else if (reader_[0] == '@' && isInclude()) {
+            if (currentSections_.empty()) {
+                loadInclude(dict, s_rootRecord);
+            }
+            else {
+                loadInclude(*(currentSections_.back()), currentRecords_.back());
+            }
+        }
         else if (reader_[0] == '{') {
             if (currentSections_.empty()) {
-                loadObject(dict);
+                loadObject(dict, s_rootRecord);
             }
             else {
-                loadObject(*(currentSections_.top()));
+                loadObject(*(currentSections_.back()), currentRecords_.back());
             }
         }
         else {
             // create the default section if needed
             if (currentSections_.empty()) {
-                currentSections_.push(&dict);
+                currentSections_.push_back(&dict);
+                currentRecords_.push_back(s_rootRecord);
             }
-            loadKey(*(currentSections_.top()));
+            loadKey(*(currentSections_.back()), currentRecords_.back());
         }
     }
 
     void loadSection(blet::Dict& dict, bool linear = false) {
+        if (stats_ != NULL) {
+            ++stats_->sections;
+        }
         ++reader_; // jump '['
         spaceJumpLine();
         // multi section
@@ -156,6 +641,7 @@ class Loader {
                 ++level;
                 spaceJumpLine();
             }
+            std::size_t offset = reader_.index();
             std::string sectionName = loadSectionName();
             std::size_t maxlevel = level - 1;
             while (reader_[0] == ']') {
@@ -167,10 +653,12 @@ class Loader {
                 throw LoadException(filename_, reader_.line(), reader_.column(), "End of section");
             }
             while (currentSections_.size() > maxlevel) {
-                currentSections_.pop();
+                currentSections_.pop_back();
+                currentRecords_.pop_back();
             }
             if (maxlevel == currentSections_.size()) {
-                currentSections_.push(&(currentSections_.top()->operator[](sectionName)));
+                currentSections_.push_back(&section(*currentSections_.back(), sectionName));
+                currentRecords_.push_back(record(currentRecords_.back(), sectionName, offset));
             }
             else {
                 throw LoadException(filename_, reader_.line(), reader_.column(), "Section without parent");
@@ -178,29 +666,235 @@ class Loader {
         }
         // basic or linear section
         else {
-            if (!linear) {
-                // clear currentSections_
-                currentSections_ = std::stack<blet::Dict*>();
+            std::size_t parentRecord = s_rootRecord;
+            if (linear) {
+                parentRecord = currentRecords_.back();
             }
+            else {
+                // clear currentSections_ and keep its capacity
+                currentSections_.clear();
+                currentRecords_.clear();
+            }
+            std::size_t offset = reader_.index();
             std::string sectionName = loadSectionName();
             if (sectionName.empty()) {
                 // set the default section
-                currentSections_.push(&dict);
+                currentSections_.push_back(&dict);
+                currentRecords_.push_back(parentRecord);
             }
             else {
                 // add new section
-                currentSections_.push(&(dict[sectionName]));
+                currentSections_.push_back(&section(dict, sectionName));
+                currentRecords_.push_back(record(parentRecord, sectionName, offset));
             }
             ++reader_; // jump ']'
         }
         spaceJumpLine();
         if (reader_[0] == '[') {
             // recursive linear
-            loadSection(*(currentSections_.top()), true);
+            loadSection(*(currentSections_.back()), true);
         }
         spaceJump();
     }
 
+    bool isInclude() {
+        if (!(reader_ == "@include")) {
+            return false;
+        }
+        std::size_t i = sizeof("@include") - 1;
+        if (reader_[i] == '"' || reader_[i] == '\'') {
+            return true;
+        }
+        if (reader_[i] != ' ' && reader_[i] != '\t') {
+            return false;
+        }
+        while (reader_[i] == ' ' || reader_[i] == '\t') {
+            ++i;
+        }
+        // "@include = value" is a key
+        return reader_[i] != '=' && reader_[i] != ':' && reader_[i] != '\n' && reader_[i] != '\0';
+    }
+
+    void loadInclude(blet::Dict& dict, std::size_t parentRecord) {
+        reader_ += sizeof("@include") - 1;
+        spaceJumpLine();
+        std::size_t line = reader_.line();
+        std::size_t column = reader_.column();
+        std::string path;
+        if (reader_[0] == '"' || reader_[0] == '\'') {
+            std::size_t start;
+            std::size_t end;
+            loadQuoteIndexes(&start, &end);
+            path = stringEscape(reader_.substr(start, end));
+        }
+        else {
+            std::size_t start = reader_.index();
+            std::size_t end = reader_.index();
+            while (reader_[0] != '\n' && reader_[0] != ';' && reader_[0] != '#' && reader_[0] != '\0') {
+                if ((reader_[0] >= '\t' && reader_[0] <= '\r') || reader_[0] == ' ') {
+                    spaceJumpLine();
+                }
+                else {
+                    ++reader_;
+                    end = reader_.index();
+                }
+            }
+            path = reader_.substr(start, end);
+        }
+        spaceJumpLine();
+        commentJump();
+        if (reader_[0] != '\n' && reader_[0] != '\0') {
+            throw LoadException(filename_, reader_.line(), reader_.column(), "End of include");
+        }
+        if (path.empty()) {
+            throw LoadException(filename_, line, column, "Include path not found");
+        }
+        // relative to the directory of current file
+        if (path[0] != '/') {
+            std::size_t pos = filename_.rfind('/');
+            if (pos != std::string::npos) {
+                path = filename_.substr(0, pos + 1) + path;
+            }
+        }
+        if (path.find_first_of("*?[") != std::string::npos) {
+            glob_t globResult;
+            int ret = ::glob(path.c_str(), 0, &s_globError, &globResult);
+            if (ret != 0 && ret != GLOB_NOMATCH) {
+                throw LoadException(filename_, line, column, "Include glob failed");
+            }
+            try {
+                for (std::size_t i = 0; ret == 0 && i < globResult.gl_pathc; ++i) {
+                    includeFile(dict, parentRecord, globResult.gl_pathv[i], line, column);
+                }
+            }
+            catch (...) {
+                ::globfree(&globResult);
+                throw;
+            }
+            ::globfree(&globResult);
+        }
+        else {
+            includeFile(dict, parentRecord, path, line, column);
+        }
+        spaceJump();
+    }
+
+    void includeFile(blet::Dict& dict, std::size_t parentRecord, const std::string& path, std::size_t line,
+                     std::size_t column) {
+        IncludeContext& context = *includeContext_;
+        if (context.stack_.empty() && !filename_.empty()) {
+            char realPath[PATH_MAX];
+            if (::realpath(filename_.c_str(), realPath) != NULL) {
+                context.stack_.push_back(realPath);
+            }
+        }
+        char realPath[PATH_MAX];
+        if (::realpath(path.c_str(), realPath) == NULL) {
+            throw LoadException(path, "Open file failed");
+        }
+        for (std::size_t i = 0; i < context.stack_.size(); ++i) {
+            if (context.stack_[i] == realPath) {
+                throw LoadException(filename_, line, column, "Include cycle");
+            }
+        }
+        std::map<std::string, IncludeContext::Fragment>::iterator it = context.fragments_.find(realPath);
+        if (it == context.fragments_.end()) {
+            // read and parse only one time by load
+            std::ifstream fileStream(path.c_str());
+            if (!fileStream.is_open()) {
+                throw LoadException(path, "Open file failed");
+            }
+            IncludeContext::Fragment fragment;
+            fragment.sourceMap = NULL;
+            it = context.fragments_.insert(std::pair<const std::string, IncludeContext::Fragment>(realPath, fragment))
+                     .first;
+            if (sourceMap_ != NULL) {
+                it->second.sourceMap = new SourceMap();
+            }
+            LoadOptions fragmentOptions(options_);
+            fragmentOptions.sourceMap = it->second.sourceMap;
+            context.stack_.push_back(realPath);
+            try {
+                Loader loader(path, fileStream, fragmentOptions, includeContext_);
+                loader.load(it->second.dict);
+                it->second.interpolations.swap(loader.interpolations_);
+            }
+            catch (...) {
+                context.stack_.pop_back();
+                delete it->second.sourceMap;
+                context.fragments_.erase(it);
+                throw;
+            }
+            context.stack_.pop_back();
+        }
+        std::vector<std::size_t> indexShifts;
+        if (sourceMap_ != NULL) {
+            indexShifts = appendShifts(dict, it->second.dict, *(it->second.sourceMap));
+        }
+        if (!it->second.dict.isNull()) {
+            // the fragment is merged like the "key[]" values
+            blet::Dict fragment(it->second.dict);
+            merge(dict, fragment, APPEND_POLICY);
+            sectionCache_.clear();
+        }
+        if (sourceMap_ != NULL) {
+            std::size_t first = sourceMap_->size();
+            sourceMap_->append(*(it->second.sourceMap), parentRecord, indexShifts);
+            for (std::size_t i = 0; i < it->second.interpolations.size(); ++i) {
+                interpolations_.push_back(first + it->second.interpolations[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Get the shift of the index records of a fragment before its merge in @p dict.
+     * The elements of a fragment array are appended after the elements of the same array in @p dict.
+     *
+     * @param dict The dict before the merge.
+     * @param fragment The dict of fragment.
+     * @param sourceMap The source map of fragment.
+     * @return std::vector<std::size_t> The shift of each record.
+     */
+    static std::vector<std::size_t> appendShifts(const blet::Dict& dict, const blet::Dict& fragment,
+                                                 const SourceMap& sourceMap) {
+        std::vector<std::size_t> shifts(sourceMap.size(), 0);
+        // the nodes of records in dict (NULL if not merged in a existing node) and in fragment
+        std::vector<const blet::Dict*> nodes(sourceMap.size(), NULL);
+        std::vector<const blet::Dict*> fragmentNodes(sourceMap.size(), NULL);
+        for (std::size_t i = 0; i < sourceMap.size(); ++i) {
+            std::size_t parent = sourceMap.parents_[i];
+            const blet::Dict* node = parent == s_rootRecord ? &dict : nodes[parent];
+            const blet::Dict* fragmentNode = parent == s_rootRecord ? &fragment : fragmentNodes[parent];
+            if (fragmentNode == NULL) {
+                continue;
+            }
+            std::size_t index = sourceMap.indexes_[i];
+            if (index != s_noIndex) {
+                if (fragmentNode->isArray()) {
+                    if (node != NULL && node->isArray()) {
+                        shifts[i] = node->getValue().getArray().size();
+                    }
+                    if (index < fragmentNode->getValue().getArray().size()) {
+                        fragmentNodes[i] = &(fragmentNode->getValue().getArray()[index]);
+                    }
+                }
+            }
+            else if (fragmentNode->isObject()) {
+                const blet::Dict::object_t& fragmentObject = fragmentNode->getValue().getObject();
+                blet::Dict::object_t::const_iterator cit = fragmentObject.find(sourceMap.keys_[i]);
+                if (cit != fragmentObject.end()) {
+                    fragmentNodes[i] = &(cit->second);
+                    if (node != NULL && node->isObject()) {
+                        const blet::Dict::object_t& object = node->getValue().getObject();
+                        blet::Dict::object_t::const_iterator baseCit = object.find(sourceMap.keys_[i]);
+                        nodes[i] = baseCit != object.end() ? &(baseCit->second) : NULL;
+                    }
+                }
+            }
+        }
+        return shifts;
+    }
+
     std::string loadSectionName() {
         std::size_t start = reader_.index();
         std::size_t end = reader_.index();
@@ -230,32 +924,42 @@ class Loader {
         }
     }
 
-    void loadKey(blet::Dict& dict) {
+    void loadKey(blet::Dict& dict, std::size_t parentRecord) {
         if (reader_[0] == '=' || reader_[0] == ':') {
             throw LoadException(filename_, reader_.line(), reader_.column(), "Key not found");
         }
-        blet::Dict* pKeyDict = loadKeyDict(dict);
+        std::size_t keyRecord = parentRecord;
+        blet::Dict* pKeyDict = loadKeyDict(dict, &keyRecord);
         spaceJump();
         if (reader_[0] != '=' && reader_[0] != ':') {
             throw LoadException(filename_, reader_.line(), reader_.column(), "Assign operator not found");
         }
         ++reader_; // jump '=' or ':'
         spaceJumpLine();
-        loadValue(*pKeyDict);
+        loadValue(*pKeyDict, keyRecord);
         spaceJump();
     }
 
-    blet::Dict* loadKeyDict(blet::Dict& dict) {
-        blet::Dict* pCurrentDict = &(dict[loadKeyName()]);
+    blet::Dict* loadKeyDict(blet::Dict& dict, std::size_t* pRecord) {
+        std::size_t offset = reader_.index();
+        std::string keyName = loadKeyName();
+        blet::Dict* pCurrentDict = &s_member(dict, keyName);
+        *pRecord = record(*pRecord, keyName, offset);
         // map key
         while (reader_[0] == '[') {
+            offset = reader_.index();
             std::string keyMapName = loadKeyMapName();
             if (keyMapName.empty()) {
-                pCurrentDict->push_back(blet::Dict());
-                pCurrentDict = &(pCurrentDict->back());
+                if (stats_ != NULL) {
+                    ++stats_->appends;
+                }
+                blet::Dict& element = s_pushBack(*pCurrentDict);
+                *pRecord = record(*pRecord, pCurrentDict->getValue().getArray().size() - 1, offset);
+                pCurrentDict = &element;
             }
             else {
-                pCurrentDict = &(pCurrentDict->operator[](keyMapName));
+                pCurrentDict = &s_member(*pCurrentDict, keyMapName);
+                *pRecord = record(*pRecord, keyMapName, offset);
             }
         }
         return pCurrentDict;
@@ -319,7 +1023,11 @@ class Loader {
         return stringEscape(reader_.substr(start, end));
     }
 
-    void loadValue(blet::Dict& dict, EValueFromType fromType = DEFAULT_VALUE_FROM_TYPE) {
+    void loadValue(blet::Dict& dict, std::size_t valueRecord, EValueFromType fromType = DEFAULT_VALUE_FROM_TYPE) {
+        if (dict.isObject()) {
+            // the sections in this object can be replaced
+            sectionCache_.clear();
+        }
         std::size_t start = reader_.index();
         std::size_t end = reader_.index();
         switch (reader_[0]) {
@@ -340,11 +1048,11 @@ class Loader {
                 break;
             }
             case '{': {
-                loadObject(dict);
+                loadObject(dict, valueRecord);
                 break;
             }
             case '[': {
-                loadArray(dict);
+                loadArray(dict, valueRecord);
                 break;
             }
             default: {
@@ -368,9 +1076,12 @@ class Loader {
                 break;
             }
         }
+        if (options_.interpolation && dict.isString() && dict.getValue().getString().find("${") != std::string::npos) {
+            interpolations_.push_back(valueRecord);
+        }
     }
 
-    void loadObject(blet::Dict& dict) {
+    void loadObject(blet::Dict& dict, std::size_t objectRecord) {
         std::size_t start = reader_.index();
         std::size_t end = reader_.index();
         bool next = false;
@@ -388,6 +1099,7 @@ class Loader {
                 throw LoadException(filename_, reader_.line(), reader_.column(), "Key not found");
             }
             // start key name
+            std::size_t offset = reader_.index();
             if (reader_[0] == '\"' || reader_[0] == '\'') {
                 loadQuoteIndexes(&start, &end);
             }
@@ -406,7 +1118,9 @@ class Loader {
                     }
                 }
             }
-            blet::Dict* objDict = &(dict.operator[](stringEscape(reader_.substr(start, end))));
+            std::string keyName = stringEscape(reader_.substr(start, end));
+            blet::Dict* objDict = &s_member(dict, keyName);
+            std::size_t keyRecord = record(objectRecord, keyName, offset);
             spaceJump();
             if (reader_[0] != '=' && reader_[0] != ':') {
                 throw LoadException(filename_, reader_.line(), reader_.column(), "Assign operator not found");
@@ -414,7 +1128,7 @@ class Loader {
             ++reader_; // jump '=' or ':'
             spaceJump();
             // recursive
-            loadValue(*objDict, OBJECT_VALUE_FROM_TYPE);
+            loadValue(*objDict, keyRecord, OBJECT_VALUE_FROM_TYPE);
             spaceJump();
             if (reader_[0] == ',') {
                 ++reader_; // jump ','
@@ -429,20 +1143,26 @@ class Loader {
         spaceJump();
     }
 
-    void loadArray(blet::Dict& dict) {
+    void loadArray(blet::Dict& dict, std::size_t arrayRecord) {
         bool next = false;
 
-        dict.newArray();
+        // the elements are loaded in the buffer of this depth for create the array with one allocation
+        if (arrayDepth_ == arrayBuffers_.size()) {
+            arrayBuffers_.push_back(blet::Dict::array_t());
+        }
+        blet::Dict::array_t& elements = arrayBuffers_[arrayDepth_];
+        elements.clear();
+        ++arrayDepth_;
         ++reader_; // jump '[]'
         spaceJump();
         while (reader_[0] != ']' || next) {
             if (reader_[0] == '\0') {
                 throw LoadException(filename_, reader_.line(), reader_.column(), "End of array");
             }
-            dict.push_back(blet::Dict());
-            blet::Dict& arrDict = dict.back();
+            blet::Dict& arrDict = s_pushBack(elements);
+            std::size_t elementRecord = record(arrayRecord, elements.size() - 1, reader_.index());
             // recursive
-            loadValue(arrDict, ARRAY_VALUE_FROM_TYPE);
+            loadValue(arrDict, elementRecord, ARRAY_VALUE_FROM_TYPE);
             spaceJump();
             if (reader_[0] == ',') {
                 ++reader_; // jump ','
@@ -453,6 +1173,15 @@ class Loader {
                 next = false;
             }
         }
+        --arrayDepth_;
+        dict.newArray();
+        blet::Dict::array_t& array = dict.getArray();
+        array.reserve(elements.size());
+        array.resize(elements.size());
+        for (std::size_t i = 0; i < elements.size(); ++i) {
+            array[i].swap(elements[i]);
+        }
+        elements.clear();
         ++reader_; // jump '}'
         spaceJump();
     }
@@ -477,7 +1206,7 @@ class Loader {
             case '7':
             case '8':
             case '9':
-                s_parseNumber(value, dict);
+                parseNumber(value, dict);
                 break;
             case 'f':
                 if (lowerStr == "false") {
@@ -577,10 +1306,12 @@ class Loader {
         }
     }
 
-    static std::string stringEscape(const std::string& str) {
+    std::string stringEscape(const std::string& str) {
         std::ostringstream oss("");
+        bool escaped = false;
         for (std::size_t i = 0; i < str.size(); ++i) {
             if (str[i] == '\\') {
+                escaped = true;
                 switch (str[i + 1]) {
                     case 'a':
                         oss << '\a';
@@ -625,10 +1356,33 @@ class Loader {
                 oss << str[i];
             }
         }
+        if (escaped && stats_ != NULL) {
+            ++stats_->escapedStrings;
+        }
         return oss.str();
     }
 
   private:
+    /**
+     * @brief Get the section @p name of @p parent from the cache of sections or the dict.
+     */
+    blet::Dict& section(blet::Dict& parent, const std::string& name) {
+        blet::Dict* section = sectionCache_.find(&parent, name);
+        if (section == NULL) {
+            section = &s_member(parent, name);
+            sectionCache_.insert(&parent, name, section);
+        }
+        return *section;
+    }
+
+    template<typename Key>
+    std::size_t record(std::size_t parent, const Key& key, std::size_t offset) {
+        if (sourceMap_ == NULL) {
+            return s_rootRecord;
+        }
+        return sourceMap_->add(parent, key, offset, file_);
+    }
+
     static bool s_hex(const std::string& value, std::ostream& stringStream) {
         std::size_t index = 0;
 
@@ -730,13 +1484,30 @@ class Loader {
         return true;
     }
 
-    static void s_parseNumber(const std::string& str, blet::Dict& dict) {
+    void parseNumber(const std::string& str, blet::Dict& dict) {
         std::stringstream stringStream("");
-        if (s_hex(str, stringStream) || s_binary(str, stringStream) || s_octal(str, stringStream) ||
-            s_double(str, stringStream)) {
+        // enough digits for read the same double
+        stringStream << std::setprecision(std::numeric_limits<double>::digits10 + 2);
+        std::size_t LoadStats::*radix = NULL;
+        if (s_hex(str, stringStream)) {
+            radix = &LoadStats::hexadecimalNumbers;
+        }
+        else if (s_binary(str, stringStream)) {
+            radix = &LoadStats::binaryNumbers;
+        }
+        else if (s_octal(str, stringStream)) {
+            radix = &LoadStats::octalNumbers;
+        }
+        else if (s_double(str, stringStream)) {
+            radix = &LoadStats::decimalNumbers;
+        }
+        if (radix != NULL) {
             double num;
             stringStream >> num;
             dict.newNumber(num);
+            if (stats_ != NULL) {
+                ++(stats_->*radix);
+            }
         }
         else {
             dict = str;
@@ -745,34 +1516,54 @@ class Loader {
 
     const std::string filename_;
     StringReader reader_;
-    std::stack<blet::Dict*> currentSections_;
+    std::vector<blet::Dict*> currentSections_;
+    std::vector<std::size_t> currentRecords_;
+    SectionCache sectionCache_;
+    const LoadOptions& options_;
+    LoadStats* stats_;
+    SourceMap ownSourceMap_;
+    SourceMap* sourceMap_;
+    std::size_t file_;
+    IncludeContext ownIncludeContext_;
+    IncludeContext* includeContext_;
+    // records of the strings with references
+    std::vector<std::size_t> interpolations_;
+    // buffers of elements by depth of inline arrays (the references stay valid at push_back)
+    std::deque<blet::Dict::array_t> arrayBuffers_;
+    std::size_t arrayDepth_;
 };
 
-blet::Dict loadFile(const char* filename) {
+blet::Dict loadFile(const char* filename, const LoadOptions& options) {
     std::ifstream fileStream(filename); // open file
     if (!fileStream.is_open()) {
         throw LoadException(filename, "Open file failed");
     }
+    if (options.stats != NULL) {
+        options.stats->clear();
+    }
     blet::Dict dict;
-    Loader loader(filename, fileStream);
+    Loader loader(filename, fileStream, options);
     loader.load(dict);
     return dict;
 }
 
-blet::Dict loadStream(std::istream& stream) {
+blet::Dict loadStream(std::istream& stream, const LoadOptions& options) {
+    if (options.stats != NULL) {
+        options.stats->clear();
+    }
     blet::Dict dict;
-    Loader loader("", stream);
+    Loader loader("", stream, options);
     loader.load(dict);
     return dict;
 }
 
-blet::Dict loadString(const std::string& str) {
+blet::Dict loadString(const std::string& str, const LoadOptions& options) {
     std::istringstream iss(str);
-    return loadStream(iss);
+    return loadStream(iss, options);
 }
 
-blet::Dict loadData(const void* data, std::size_t size) {
-    return loadString(std::string(static_cast<const char*>(data), size));
+blet::Dict loadData(const void* data, std::size_t size, const LoadOptions& options) {
+    return loadString(std::string(static_cast<const char*>(data), size), options);
 }
 
 } // namespace conf
@@ -0,0 +1,94 @@
+/**
+ * memoryResource.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <new> // ::operator new
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+/**
+ * @brief Resource of the global operator new and delete.
+ */
+class NewDeleteResource : public MemoryResource {
+  public:
+    NewDeleteResource() {}
+    ~NewDeleteResource() {}
+
+    void* allocate(std::size_t size) {
+        return ::operator new(size);
+    }
+
+    void deallocate(void* pointer, std::size_t /*size*/) {
+        ::operator delete(pointer);
+    }
+};
+
+MemoryResource& newDeleteResource() {
+    static NewDeleteResource resource;
+    return resource;
+}
+
+CountingMemoryResource::CountingMemoryResource(MemoryResource& upstream) :
+    upstream_(upstream),
+    allocated_(0),
+    peak_(0),
+    allocations_(0) {}
+
+CountingMemoryResource::~CountingMemoryResource() {}
+
+void* CountingMemoryResource::allocate(std::size_t size) {
+    void* pointer = upstream_.allocate(size);
+    __atomic_add_fetch(&allocations_, 1, __ATOMIC_SEQ_CST);
+    std::size_t allocated = __atomic_add_fetch(&allocated_, size, __ATOMIC_SEQ_CST);
+    std::size_t peak = __atomic_load_n(&peak_, __ATOMIC_SEQ_CST);
+    while (peak < allocated &&
+           !__atomic_compare_exchange_n(&peak_, &peak, allocated, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+    }
+    return pointer;
+}
+
+void CountingMemoryResource::deallocate(void* pointer, std::size_t size) {
+    upstream_.deallocate(pointer, size);
+    __atomic_sub_fetch(&allocated_, size, __ATOMIC_SEQ_CST);
+}
+
+std::size_t CountingMemoryResource::allocated() const {
+    return __atomic_load_n(&allocated_, __ATOMIC_SEQ_CST);
+}
+
+std::size_t CountingMemoryResource::peak() const {
+    return __atomic_load_n(&peak_, __ATOMIC_SEQ_CST);
+}
+
+std::size_t CountingMemoryResource::allocations() const {
+    return __atomic_load_n(&allocations_, __ATOMIC_SEQ_CST);
+}
+
+} // namespace conf
+
+} // namespace blet
@@ -0,0 +1,162 @@
+/**
+ * merge.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+class Merger {
+  public:
+    Merger(enum EMergePolicy policy) :
+        policy_(policy) {}
+
+    ~Merger() {}
+
+    void check(const blet::Dict& dict, const blet::Dict& layer) {
+        if (dict.isObject() && layer.isObject()) {
+            const blet::Dict::object_t& object = dict.getValue().getObject();
+            const blet::Dict::object_t& layerObject = layer.getValue().getObject();
+            for (blet::Dict::object_t::const_iterator layerCit = layerObject.begin(); layerCit != layerObject.end();
+                 ++layerCit) {
+                blet::Dict::object_t::const_iterator cit = object.find(layerCit->first);
+                if (cit != object.end()) {
+                    path_.push_back(layerCit->first);
+                    check(cit->second, layerCit->second);
+                    path_.pop_back();
+                }
+            }
+        }
+        else if (!s_equal(dict, layer)) {
+            throw MergeException(pathToString(), "Conflict");
+        }
+    }
+
+    void merge(blet::Dict& dict, blet::Dict& layer) {
+        if (dict.isObject() && layer.isObject()) {
+            mergeObject(dict.getValue().getObject(), layer.getValue().getObject());
+        }
+        else if (policy_ == APPEND_POLICY && dict.isArray() && layer.isArray()) {
+            appendArray(dict.getValue().getArray(), layer.getValue().getArray());
+        }
+        else {
+            dict.swap(layer);
+        }
+    }
+
+  private:
+    static bool s_equal(const blet::Dict& dict, const blet::Dict& layer) {
+        if (dict.getType() != layer.getType()) {
+            return false;
+        }
+        bool equal = true;
+        switch (dict.getType()) {
+            case blet::Dict::NULL_TYPE:
+                break;
+            case blet::Dict::BOOLEAN_TYPE:
+                equal = dict.getValue().getBoolean() == layer.getValue().getBoolean();
+                break;
+            case blet::Dict::NUMBER_TYPE:
+                equal = dict.getValue().getNumber() == layer.getValue().getNumber();
+                break;
+            case blet::Dict::STRING_TYPE:
+                equal = dict.getValue().getString() == layer.getValue().getString();
+                break;
+            case blet::Dict::ARRAY_TYPE: {
+                const blet::Dict::array_t& array = dict.getValue().getArray();
+                const blet::Dict::array_t& layerArray = layer.getValue().getArray();
+                equal = array.size() == layerArray.size();
+                for (std::size_t i = 0; equal && i < array.size(); ++i) {
+                    equal = s_equal(array[i], layerArray[i]);
+                }
+                break;
+            }
+            case blet::Dict::OBJECT_TYPE: {
+                const blet::Dict::object_t& object = dict.getValue().getObject();
+                const blet::Dict::object_t& layerObject = layer.getValue().getObject();
+                equal = object.size() == layerObject.size();
+                blet::Dict::object_t::const_iterator layerCit = layerObject.begin();
+                for (blet::Dict::object_t::const_iterator cit = object.begin(); equal && cit != object.end();
+                     ++cit, ++layerCit) {
+                    equal = cit->first == layerCit->first && s_equal(cit->second, layerCit->second);
+                }
+                break;
+            }
+        }
+        return equal;
+    }
+
+    void mergeObject(blet::Dict::object_t& object, blet::Dict::object_t& layerObject) {
+        for (blet::Dict::object_t::iterator layerIt = layerObject.begin(); layerIt != layerObject.end(); ++layerIt) {
+            // search in the large base without walk all its keys
+            blet::Dict::object_t::iterator it = object.lower_bound(layerIt->first);
+            if (it == object.end() || layerIt->first < it->first) {
+                // only in layer
+                it = object.insert(it, blet::Dict::object_t::value_type(layerIt->first, blet::Dict()));
+                it->second.swap(layerIt->second);
+            }
+            else {
+                merge(it->second, layerIt->second);
+            }
+        }
+    }
+
+    void appendArray(blet::Dict::array_t& array, blet::Dict::array_t& layerArray) {
+        // relocate the elements by swap for not copy their contents
+        blet::Dict::array_t relocated(array.size() + layerArray.size());
+        for (std::size_t i = 0; i < array.size(); ++i) {
+            relocated[i].swap(array[i]);
+        }
+        for (std::size_t i = 0; i < layerArray.size(); ++i) {
+            relocated[array.size() + i].swap(layerArray[i]);
+        }
+        array.swap(relocated);
+    }
+
+    std::string pathToString() const {
+        std::string path;
+        for (blet::Dict::Path::const_iterator cit = path_.begin(); cit != path_.end(); ++cit) {
+            Accessor::appendKey(path, cit->getValue().getString());
+        }
+        return path;
+    }
+
+    enum EMergePolicy policy_;
+    blet::Dict::Path path_;
+};
+
+void merge(blet::Dict& dict, blet::Dict& layer, enum EMergePolicy policy) {
+    Merger merger(policy);
+    if (policy == ERROR_POLICY) {
+        // check before any modification
+        merger.check(dict, layer);
+    }
+    merger.merge(dict, layer);
+}
+
+} // namespace conf
+
+} // namespace blet
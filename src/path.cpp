@@ -0,0 +1,119 @@
+/**
+ * path.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pthread.h>
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+static pthread_once_t s_keyBufferOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t s_keyBufferKey;
+
+static void s_deleteKeyBuffer(void* buffer) {
+    delete static_cast<std::string*>(buffer);
+}
+
+static void s_createKeyBuffer() {
+    ::pthread_key_create(&s_keyBufferKey, &s_deleteKeyBuffer);
+}
+
+/**
+ * @brief Get the key buffer of the current thread.
+ * Its capacity is kept between the lookups.
+ */
+static std::string& s_keyBuffer() {
+    ::pthread_once(&s_keyBufferOnce, &s_createKeyBuffer);
+    std::string* buffer = static_cast<std::string*>(::pthread_getspecific(s_keyBufferKey));
+    if (buffer == NULL) {
+        buffer = new std::string();
+        ::pthread_setspecific(s_keyBufferKey, buffer);
+    }
+    return *buffer;
+}
+
+Path& Path::operator[](std::size_t index) {
+    if (size_ == MAX_SEGMENTS) {
+        throw std::length_error("Path has too many segments");
+    }
+    segments_[size_].key = NULL;
+    segments_[size_].size = 0;
+    segments_[size_].index = index;
+    ++size_;
+    return *this;
+}
+
+Path& Path::key(const char* data, std::size_t size) {
+    if (size_ == MAX_SEGMENTS) {
+        throw std::length_error("Path has too many segments");
+    }
+    segments_[size_].key = data;
+    segments_[size_].size = size;
+    segments_[size_].index = 0;
+    ++size_;
+    return *this;
+}
+
+const blet::Dict* Path::find(const blet::Dict& dict) const {
+    const blet::Dict* node = &dict;
+    for (std::size_t i = 0; i < size_ && node != NULL; ++i) {
+        if (segments_[i].key == NULL) {
+            if (node->isArray() && segments_[i].index < node->getValue().getArray().size()) {
+                node = &node->getValue().getArray()[segments_[i].index];
+            }
+            else {
+                node = NULL;
+            }
+        }
+        else {
+            node = blet::conf::find(*node, segments_[i].key, segments_[i].size);
+        }
+    }
+    return node;
+}
+
+const blet::Dict& Path::at(const blet::Dict& dict) const {
+    const blet::Dict* node = find(dict);
+    if (node == NULL) {
+        throw std::out_of_range("Path not found");
+    }
+    return *node;
+}
+
+const blet::Dict* find(const blet::Dict& dict, const char* key, std::size_t size) {
+    if (!dict.isObject()) {
+        return NULL;
+    }
+    std::string& buffer = s_keyBuffer();
+    buffer.assign(key, size);
+    blet::Dict::object_t::const_iterator cit = dict.getValue().getObject().find(buffer);
+    return cit != dict.getValue().getObject().end() ? &cit->second : NULL;
+}
+
+} // namespace conf
+
+} // namespace blet
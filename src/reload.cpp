@@ -0,0 +1,160 @@
+/**
+ * reload.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+class Reloader {
+  public:
+    Reloader(Changes& changes) :
+        changes_(changes) {}
+
+    ~Reloader() {}
+
+    void reload(blet::Dict& dict, blet::Dict& newDict) {
+        if (dict.getType() != newDict.getType()) {
+            dict.swap(newDict);
+            changes_.modified.push_back(path_);
+            return;
+        }
+        switch (dict.getType()) {
+            case blet::Dict::NULL_TYPE:
+                break;
+            case blet::Dict::BOOLEAN_TYPE:
+                if (dict.getValue().getBoolean() != newDict.getValue().getBoolean()) {
+                    dict.swap(newDict);
+                    changes_.modified.push_back(path_);
+                }
+                break;
+            case blet::Dict::NUMBER_TYPE:
+                if (dict.getValue().getNumber() != newDict.getValue().getNumber()) {
+                    dict.swap(newDict);
+                    changes_.modified.push_back(path_);
+                }
+                break;
+            case blet::Dict::STRING_TYPE:
+                if (dict.getValue().getString() != newDict.getValue().getString()) {
+                    dict.swap(newDict);
+                    changes_.modified.push_back(path_);
+                }
+                break;
+            case blet::Dict::ARRAY_TYPE:
+                reloadArray(dict.getValue().getArray(), newDict.getValue().getArray());
+                break;
+            case blet::Dict::OBJECT_TYPE:
+                reloadObject(dict.getValue().getObject(), newDict.getValue().getObject());
+                break;
+        }
+    }
+
+  private:
+    void reloadArray(blet::Dict::array_t& array, blet::Dict::array_t& newArray) {
+        std::size_t size = array.size() < newArray.size() ? array.size() : newArray.size();
+        for (std::size_t i = 0; i < size; ++i) {
+            path_.push_back(i);
+            reload(array[i], newArray[i]);
+            path_.pop_back();
+        }
+        if (array.size() > newArray.size()) {
+            for (std::size_t i = newArray.size(); i < array.size(); ++i) {
+                path_.push_back(i);
+                changes_.removed.push_back(path_);
+                path_.pop_back();
+            }
+            array.erase(array.begin() + newArray.size(), array.end());
+        }
+        else if (array.size() < newArray.size()) {
+            // relocate the old elements by swap for not copy their contents
+            blet::Dict::array_t relocated(newArray.size());
+            for (std::size_t i = 0; i < array.size(); ++i) {
+                relocated[i].swap(array[i]);
+            }
+            for (std::size_t i = array.size(); i < newArray.size(); ++i) {
+                relocated[i].swap(newArray[i]);
+                path_.push_back(i);
+                changes_.added.push_back(path_);
+                path_.pop_back();
+            }
+            array.swap(relocated);
+        }
+    }
+
+    void reloadObject(blet::Dict::object_t& object, blet::Dict::object_t& newObject) {
+        blet::Dict::object_t::iterator it = object.begin();
+        blet::Dict::object_t::iterator newIt = newObject.begin();
+        while (it != object.end() || newIt != newObject.end()) {
+            if (newIt == newObject.end() || (it != object.end() && it->first < newIt->first)) {
+                // only in old object
+                path_.push_back(it->first);
+                changes_.removed.push_back(path_);
+                path_.pop_back();
+                object.erase(it++);
+            }
+            else if (it == object.end() || newIt->first < it->first) {
+                // only in new object
+                blet::Dict::object_t::iterator addIt =
+                    object.insert(it, blet::Dict::object_t::value_type(newIt->first, blet::Dict()));
+                addIt->second.swap(newIt->second);
+                path_.push_back(newIt->first);
+                changes_.added.push_back(path_);
+                path_.pop_back();
+                ++newIt;
+            }
+            else {
+                path_.push_back(it->first);
+                reload(it->second, newIt->second);
+                path_.pop_back();
+                ++it;
+                ++newIt;
+            }
+        }
+    }
+
+    Changes& changes_;
+    blet::Dict::Path path_;
+};
+
+bool Changes::empty() const {
+    return added.empty() && removed.empty() && modified.empty();
+}
+
+Changes reload(blet::Dict& dict, blet::Dict& newDict) {
+    Changes changes;
+    Reloader reloader(changes);
+    reloader.reload(dict, newDict);
+    return changes;
+}
+
+Changes reloadFile(blet::Dict& dict, const char* filename) {
+    blet::Dict newDict = loadFile(filename);
+    return reload(dict, newDict);
+}
+
+} // namespace conf
+
+} // namespace blet
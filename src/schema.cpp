@@ -0,0 +1,281 @@
+/**
+ * schema.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <regex.h>
+
+#include <sstream> // std::ostringstream
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+struct Schema::Pattern {
+    std::string source;
+    regex_t regex;
+};
+
+class Schema::Validator {
+  public:
+    Validator(std::vector<LoadException>& errors, const SourceMap* sourceMap) :
+        errors_(errors),
+        sourceMap_(sourceMap),
+        keys_(),
+        indexes_() {}
+
+    ~Validator() {}
+
+    void validate(const Schema& schema, const blet::Dict& dict) {
+        if ((schema.flags_ & TYPE_FLAG) && dict.getType() != schema.type_) {
+            error(std::string("is not a ") + blet::Dict::typeToStr(schema.type_) + " (is " +
+                  blet::Dict::typeToStr(dict.getType()) + ")");
+            return;
+        }
+        if ((schema.flags_ & RANGE_FLAG) && dict.isNumber()) {
+            blet::Dict::number_t number = dict.getValue().getNumber();
+            if (number < schema.min_ || number > schema.max_) {
+                std::ostringstream oss("");
+                oss << "is out of range [" << schema.min_ << ", " << schema.max_ << "]";
+                error(oss.str());
+            }
+        }
+        if (schema.pattern_ != NULL && dict.isString()) {
+            if (::regexec(&schema.pattern_->regex, dict.getValue().getString().c_str(), 0, NULL, 0) != 0) {
+                error("does not match \"" + schema.pattern_->source + "\"");
+            }
+        }
+        if ((schema.flags_ & SIZE_FLAG) && dict.isArray()) {
+            std::size_t size = dict.getValue().getArray().size();
+            if (size < schema.minSize_ || size > schema.maxSize_) {
+                std::ostringstream oss("");
+                oss << "size " << size << " is out of range [" << schema.minSize_ << ", " << schema.maxSize_ << "]";
+                error(oss.str());
+            }
+        }
+        if (dict.isObject()) {
+            validateObject(schema, dict.getValue().getObject());
+        }
+        else {
+            // a not object value has not the required keys
+            for (std::map<std::string, Schema*>::const_iterator cit = schema.keys_.begin(); cit != schema.keys_.end();
+                 ++cit) {
+                if (cit->second->flags_ & REQUIRED_FLAG) {
+                    push(cit->first);
+                    error("is not found");
+                    pop();
+                }
+            }
+        }
+        if (schema.items_ != NULL && dict.isArray()) {
+            const blet::Dict::array_t& array = dict.getValue().getArray();
+            for (std::size_t i = 0; i < array.size(); ++i) {
+                push(i);
+                validate(*schema.items_, array[i]);
+                pop();
+            }
+        }
+    }
+
+  private:
+    void validateObject(const Schema& schema, const blet::Dict::object_t& object) {
+        // merge walk of the sorted keys of rules and object
+        std::map<std::string, Schema*>::const_iterator rule = schema.keys_.begin();
+        blet::Dict::object_t::const_iterator cit = object.begin();
+        while (rule != schema.keys_.end() || cit != object.end()) {
+            if (cit == object.end() || (rule != schema.keys_.end() && rule->first < cit->first)) {
+                if (rule->second->flags_ & REQUIRED_FLAG) {
+                    push(rule->first);
+                    error("is not found");
+                    pop();
+                }
+                ++rule;
+            }
+            else if (rule == schema.keys_.end() || cit->first < rule->first) {
+                if (schema.wildcard_ != NULL) {
+                    push(cit->first);
+                    validate(*schema.wildcard_, cit->second);
+                    pop();
+                }
+                ++cit;
+            }
+            else {
+                push(cit->first);
+                validate(*rule->second, cit->second);
+                pop();
+                ++rule;
+                ++cit;
+            }
+        }
+    }
+
+    void push(const std::string& key) {
+        keys_.push_back(&key);
+        indexes_.push_back(0);
+    }
+
+    void push(std::size_t index) {
+        keys_.push_back(NULL);
+        indexes_.push_back(index);
+    }
+
+    void pop() {
+        keys_.pop_back();
+        indexes_.pop_back();
+    }
+
+    void error(const std::string& message) {
+        // the path is only formatted on error
+        std::string path;
+        for (std::size_t i = 0; i < keys_.size(); ++i) {
+            if (keys_[i] == NULL) {
+                Accessor::appendIndex(path, indexes_[i]);
+            }
+            else {
+                Accessor::appendKey(path, *keys_[i]);
+            }
+        }
+        if (sourceMap_ == NULL) {
+            errors_.push_back(LoadException("", path + ": " + message));
+        }
+        else {
+            errors_.push_back(sourceMap_->locate(path, path + ": " + message));
+        }
+    }
+
+    std::vector<LoadException>& errors_;
+    const SourceMap* sourceMap_;
+    std::vector<const std::string*> keys_;
+    std::vector<std::size_t> indexes_;
+};
+
+Schema::Schema() :
+    flags_(0),
+    type_(blet::Dict::NULL_TYPE),
+    min_(0),
+    max_(0),
+    minSize_(0),
+    maxSize_(0),
+    pattern_(NULL),
+    keys_(),
+    wildcard_(NULL),
+    items_(NULL) {}
+
+Schema::~Schema() {
+    if (pattern_ != NULL) {
+        ::regfree(&pattern_->regex);
+        delete pattern_;
+    }
+    for (std::map<std::string, Schema*>::iterator it = keys_.begin(); it != keys_.end(); ++it) {
+        delete it->second;
+    }
+    delete wildcard_;
+    delete items_;
+}
+
+Schema& Schema::key(const std::string& key) {
+    if (key == "*") {
+        if (wildcard_ == NULL) {
+            wildcard_ = new Schema();
+        }
+        return *wildcard_;
+    }
+    std::map<std::string, Schema*>::iterator it = keys_.lower_bound(key);
+    if (it == keys_.end() || it->first != key) {
+        it = keys_.insert(it, std::pair<const std::string, Schema*>(key, NULL));
+        it->second = new Schema();
+    }
+    return *it->second;
+}
+
+Schema& Schema::items() {
+    if (items_ == NULL) {
+        items_ = new Schema();
+    }
+    return *items_;
+}
+
+Schema& Schema::required(bool required) {
+    if (required) {
+        flags_ |= REQUIRED_FLAG;
+    }
+    else {
+        flags_ &= ~static_cast<unsigned int>(REQUIRED_FLAG);
+    }
+    return *this;
+}
+
+Schema& Schema::type(blet::Dict::EType type) {
+    flags_ |= TYPE_FLAG;
+    type_ = type;
+    return *this;
+}
+
+Schema& Schema::range(double min, double max) {
+    flags_ |= RANGE_FLAG;
+    min_ = min;
+    max_ = max;
+    return *this;
+}
+
+Schema& Schema::pattern(const char* pattern) {
+    Pattern* newPattern = new Pattern();
+    newPattern->source = pattern;
+    if (::regcomp(&newPattern->regex, pattern, REG_EXTENDED | REG_NOSUB) != 0) {
+        delete newPattern;
+        throw std::invalid_argument(std::string("Invalid pattern \"") + pattern + "\"");
+    }
+    if (pattern_ != NULL) {
+        ::regfree(&pattern_->regex);
+        delete pattern_;
+    }
+    pattern_ = newPattern;
+    return *this;
+}
+
+Schema& Schema::size(std::size_t min, std::size_t max) {
+    flags_ |= SIZE_FLAG;
+    minSize_ = min;
+    maxSize_ = max;
+    return *this;
+}
+
+std::vector<LoadException> Schema::validate(const blet::Dict& dict) const {
+    std::vector<LoadException> errors;
+    Validator validator(errors, NULL);
+    validator.validate(*this, dict);
+    return errors;
+}
+
+std::vector<LoadException> Schema::validate(const blet::Dict& dict, const SourceMap& sourceMap) const {
+    std::vector<LoadException> errors;
+    Validator validator(errors, &sourceMap);
+    validator.validate(*this, dict);
+    return errors;
+}
+
+} // namespace conf
+
+} // namespace blet
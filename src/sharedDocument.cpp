@@ -0,0 +1,434 @@
+/**
+ * sharedDocument.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+static const char s_magic[8] = {'B', 'L', 'E', 'T', 'C', 'O', 'N', 'F'};
+
+/**
+ * @brief Value of document, the children and the strings are at a offset of the start of memory.
+ */
+struct SharedNode {
+    uint64_t type;
+    // boolean, bits of number or offset of string, array or object
+    uint64_t first;
+    // size of string, array or object
+    uint64_t second;
+};
+
+/**
+ * @brief Member of object, the members are sorted by key.
+ */
+struct SharedEntry {
+    uint64_t key;
+    uint64_t keySize;
+    SharedNode value;
+};
+
+struct SharedHeader {
+    char magic[8];
+    uint64_t size;
+    SharedNode root;
+};
+
+/**
+ * @brief Write a dict in the layout of document.
+ * Without data, only compute the size of document.
+ */
+class SharedWriter {
+  public:
+    SharedWriter(char* data) :
+        data_(data),
+        end_(sizeof(SharedHeader)) {}
+
+    ~SharedWriter() {}
+
+    void writeNode(const blet::Dict& dict, std::size_t nodeOffset) {
+        SharedNode node;
+        node.type = dict.getType();
+        node.first = 0;
+        node.second = 0;
+        switch (dict.getType()) {
+            case blet::Dict::NULL_TYPE:
+                break;
+            case blet::Dict::BOOLEAN_TYPE:
+                node.first = dict.getValue().getBoolean();
+                break;
+            case blet::Dict::NUMBER_TYPE: {
+                double number = dict.getValue().getNumber();
+                ::memcpy(&node.first, &number, sizeof(node.first));
+                break;
+            }
+            case blet::Dict::STRING_TYPE: {
+                const std::string& str = dict.getValue().getString();
+                node.first = writeString(str.data(), str.size());
+                node.second = str.size();
+                break;
+            }
+            case blet::Dict::ARRAY_TYPE: {
+                const blet::Dict::array_t& array = dict.getValue().getArray();
+                node.first = allocate(array.size() * sizeof(SharedNode));
+                node.second = array.size();
+                for (std::size_t i = 0; i < array.size(); ++i) {
+                    writeNode(array[i], node.first + i * sizeof(SharedNode));
+                }
+                break;
+            }
+            case blet::Dict::OBJECT_TYPE: {
+                const blet::Dict::object_t& object = dict.getValue().getObject();
+                node.first = allocate(object.size() * sizeof(SharedEntry));
+                node.second = object.size();
+                std::size_t entryOffset = node.first;
+                for (blet::Dict::object_t::const_iterator cit = object.begin(); cit != object.end(); ++cit) {
+                    uint64_t key[2];
+                    key[0] = writeString(cit->first.data(), cit->first.size());
+                    key[1] = cit->first.size();
+                    if (data_ != NULL) {
+                        ::memcpy(data_ + entryOffset, key, sizeof(key));
+                    }
+                    writeNode(cit->second, entryOffset + offsetof(SharedEntry, value));
+                    entryOffset += sizeof(SharedEntry);
+                }
+                break;
+            }
+        }
+        if (data_ != NULL) {
+            ::memcpy(data_ + nodeOffset, &node, sizeof(SharedNode));
+        }
+    }
+
+    std::size_t size() const {
+        return end_;
+    }
+
+  private:
+    SharedWriter(const SharedWriter&);
+    SharedWriter& operator=(const SharedWriter&);
+
+    std::size_t allocate(std::size_t size) {
+        std::size_t offset = end_;
+        // keep the alignment of nodes
+        end_ += (size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+        return offset;
+    }
+
+    std::size_t writeString(const char* str, std::size_t size) {
+        std::size_t offset = allocate(size + 1);
+        if (data_ != NULL) {
+            ::memcpy(data_ + offset, str, size);
+            data_[offset + size] = '\0';
+        }
+        return offset;
+    }
+
+    char* data_;
+    std::size_t end_;
+};
+
+static const SharedNode& s_node(const void* node) {
+    return *static_cast<const SharedNode*>(node);
+}
+
+static const SharedEntry* s_entries(const char* base, const void* node) {
+    return reinterpret_cast<const SharedEntry*>(base + s_node(node).first);
+}
+
+static void s_typeError(const char* typeName, blet::Dict::EType type) {
+    throw std::invalid_argument(std::string("is not a ") + typeName + " (is " + blet::Dict::typeToStr(type) + ")");
+}
+
+static void s_toDict(const SharedDocument::Value& value, blet::Dict& dict) {
+    switch (value.getType()) {
+        case blet::Dict::NULL_TYPE:
+            break;
+        case blet::Dict::BOOLEAN_TYPE:
+            dict.newBoolean(value.getBoolean());
+            break;
+        case blet::Dict::NUMBER_TYPE:
+            dict.newNumber(value.getNumber());
+            break;
+        case blet::Dict::STRING_TYPE:
+            dict.newString(value.getString());
+            break;
+        case blet::Dict::ARRAY_TYPE: {
+            dict.newArray();
+            blet::Dict::array_t& array = dict.getArray();
+            array.resize(value.size());
+            for (std::size_t i = 0; i < array.size(); ++i) {
+                s_toDict(value[i], array[i]);
+            }
+            break;
+        }
+        case blet::Dict::OBJECT_TYPE: {
+            dict.newObject();
+            blet::Dict::object_t& object = dict.getObject();
+            for (std::size_t i = 0; i < value.size(); ++i) {
+                // the keys are sorted, insert at the end
+                blet::Dict::object_t::iterator it =
+                    object.insert(object.end(), blet::Dict::object_t::value_type(value.key(i), blet::Dict()));
+                s_toDict(value.value(i), it->second);
+            }
+            break;
+        }
+    }
+}
+
+SharedDocument::Value::Value() :
+    base_(NULL),
+    node_(NULL) {}
+
+SharedDocument::Value::Value(const char* base, const void* node) :
+    base_(base),
+    node_(node) {}
+
+blet::Dict::EType SharedDocument::Value::getType() const {
+    if (node_ == NULL) {
+        return blet::Dict::NULL_TYPE;
+    }
+    return static_cast<blet::Dict::EType>(s_node(node_).type);
+}
+
+bool SharedDocument::Value::getBoolean() const {
+    if (!isBoolean()) {
+        s_typeError("boolean", getType());
+    }
+    return s_node(node_).first != 0;
+}
+
+double SharedDocument::Value::getNumber() const {
+    if (!isNumber()) {
+        s_typeError("number", getType());
+    }
+    double number;
+    ::memcpy(&number, &s_node(node_).first, sizeof(number));
+    return number;
+}
+
+const char* SharedDocument::Value::c_str() const {
+    if (!isString()) {
+        s_typeError("string", getType());
+    }
+    return base_ + s_node(node_).first;
+}
+
+std::string SharedDocument::Value::getString() const {
+    return std::string(c_str(), s_node(node_).second);
+}
+
+std::size_t SharedDocument::Value::size() const {
+    if (isString() || isArray() || isObject()) {
+        return s_node(node_).second;
+    }
+    return 0;
+}
+
+SharedDocument::Value SharedDocument::Value::operator[](std::size_t index) const {
+    if (!isArray() || index >= s_node(node_).second) {
+        throw std::out_of_range("Index out of range");
+    }
+    return Value(base_, base_ + s_node(node_).first + index * sizeof(SharedNode));
+}
+
+const void* SharedDocument::Value::member(const std::string& key) const {
+    if (!isObject()) {
+        return NULL;
+    }
+    const SharedEntry* entries = s_entries(base_, node_);
+    std::size_t first = 0;
+    std::size_t last = s_node(node_).second;
+    // binary search in the order of std::string::compare
+    while (first < last) {
+        std::size_t middle = first + (last - first) / 2;
+        int compare = key.compare(0, key.size(), base_ + entries[middle].key, entries[middle].keySize);
+        if (compare == 0) {
+            return &entries[middle].value;
+        }
+        if (compare < 0) {
+            last = middle;
+        }
+        else {
+            first = middle + 1;
+        }
+    }
+    return NULL;
+}
+
+SharedDocument::Value SharedDocument::Value::operator[](const std::string& key) const {
+    const void* node = member(key);
+    if (node == NULL) {
+        throw std::out_of_range("Key \"" + key + "\" not found");
+    }
+    return Value(base_, node);
+}
+
+bool SharedDocument::Value::contains(const std::string& key) const {
+    return member(key) != NULL;
+}
+
+std::string SharedDocument::Value::key(std::size_t index) const {
+    if (!isObject() || index >= s_node(node_).second) {
+        throw std::out_of_range("Index out of range");
+    }
+    const SharedEntry& entry = s_entries(base_, node_)[index];
+    return std::string(base_ + entry.key, entry.keySize);
+}
+
+SharedDocument::Value SharedDocument::Value::value(std::size_t index) const {
+    if (!isObject() || index >= s_node(node_).second) {
+        throw std::out_of_range("Index out of range");
+    }
+    return Value(base_, &s_entries(base_, node_)[index].value);
+}
+
+blet::Dict SharedDocument::Value::toDict() const {
+    blet::Dict dict;
+    s_toDict(*this, dict);
+    return dict;
+}
+
+SharedDocument::SharedDocument() :
+    data_(NULL),
+    size_(0) {}
+
+SharedDocument::~SharedDocument() {
+    close();
+}
+
+void SharedDocument::create(const char* name, const blet::Dict& dict, unsigned int mode) {
+    SharedWriter sizer(NULL);
+    sizer.writeNode(dict, offsetof(SharedHeader, root));
+    std::size_t size = sizer.size();
+
+    // new memory for not change the documents already opened
+    ::shm_unlink(name);
+    int fd = ::shm_open(name, O_CREAT | O_EXCL | O_RDWR, mode);
+    if (fd == -1) {
+        throw LoadException(name, "Create shared memory failed");
+    }
+    if (::ftruncate(fd, size) == -1) {
+        ::close(fd);
+        ::shm_unlink(name);
+        throw LoadException(name, "Create shared memory failed");
+    }
+    void* data = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        ::shm_unlink(name);
+        throw LoadException(name, "Map shared memory failed");
+    }
+    SharedWriter writer(static_cast<char*>(data));
+    writer.writeNode(dict, offsetof(SharedHeader, root));
+    SharedHeader* header = static_cast<SharedHeader*>(data);
+    header->size = size;
+    // the magic at the end for invalid the document during the creation
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    ::memcpy(header->magic, s_magic, sizeof(s_magic));
+    ::munmap(data, size);
+}
+
+void SharedDocument::unlink(const char* name) {
+    ::shm_unlink(name);
+}
+
+void SharedDocument::open(const char* name) {
+    close();
+    int fd = ::shm_open(name, O_RDONLY, 0);
+    if (fd == -1) {
+        throw LoadException(name, "Open shared memory failed");
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == -1 || static_cast<std::size_t>(st.st_size) < sizeof(SharedHeader)) {
+        ::close(fd);
+        throw LoadException(name, "Invalid shared document");
+    }
+    std::size_t size = st.st_size;
+    void* data = ::mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw LoadException(name, "Map shared memory failed");
+    }
+    const SharedHeader* header = static_cast<const SharedHeader*>(data);
+    if (::memcmp(header->magic, s_magic, sizeof(s_magic)) != 0 || header->size != size) {
+        ::munmap(data, size);
+        throw LoadException(name, "Invalid shared document");
+    }
+    data_ = static_cast<const char*>(data);
+    size_ = size;
+}
+
+void SharedDocument::close() {
+    if (data_ != NULL) {
+        ::munmap(const_cast<char*>(data_), size_);
+        data_ = NULL;
+        size_ = 0;
+    }
+}
+
+SharedDocument::Value SharedDocument::root() const {
+    if (data_ == NULL) {
+        return Value();
+    }
+    return Value(data_, &reinterpret_cast<const SharedHeader*>(data_)->root);
+}
+
+bool SharedDocument::find(const Accessor& accessor, Value& value) const {
+    if (data_ == NULL) {
+        return false;
+    }
+    Value node = root();
+    for (std::size_t i = 0; i < accessor.segments_.size(); ++i) {
+        if (accessor.segments_[i].isIndex) {
+            if (!node.isArray() || accessor.segments_[i].index >= node.size()) {
+                return false;
+            }
+            node = node[accessor.segments_[i].index];
+        }
+        else {
+            const void* member = node.member(accessor.segments_[i].key);
+            if (member == NULL) {
+                return false;
+            }
+            node = Value(data_, member);
+        }
+    }
+    value = node;
+    return true;
+}
+
+} // namespace conf
+
+} // namespace blet
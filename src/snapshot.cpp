@@ -0,0 +1,188 @@
+/**
+ * snapshot.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include <new>
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+/**
+ * @brief Published dict with its version and the epoch of its replacement.
+ */
+struct Snapshot::Document {
+    Document(unsigned long version_) :
+        dict(),
+        version(version_),
+        epoch(0) {}
+    ~Document() {}
+
+    blet::Dict dict;
+    unsigned long version;
+    unsigned long epoch;
+};
+
+/**
+ * @brief Mutex of the publishers and of the list of readers.
+ */
+struct Snapshot::Mutex {
+    Mutex() {
+        pthread_mutex_init(&mutex, NULL);
+    }
+    ~Mutex() {
+        pthread_mutex_destroy(&mutex);
+    }
+
+    pthread_mutex_t mutex;
+};
+
+/**
+ * @brief Epoch of a reader alone in a aligned block of two cache lines (the adjacent line is prefetched together).
+ */
+struct ReaderEpoch {
+    unsigned long epoch;
+    char padding[128 - sizeof(unsigned long)];
+};
+
+static const std::size_t s_readerEpochAlignment = 128;
+
+Snapshot::Reader::Reader(Snapshot& snapshot) :
+    snapshot_(snapshot),
+    epoch_(NULL),
+    nested_(0),
+    document_(NULL) {
+    void* readerEpoch = NULL;
+    if (::posix_memalign(&readerEpoch, s_readerEpochAlignment, sizeof(ReaderEpoch)) != 0) {
+        throw std::bad_alloc();
+    }
+    epoch_ = &(static_cast<ReaderEpoch*>(readerEpoch)->epoch);
+    *epoch_ = 0;
+    pthread_mutex_lock(&snapshot_.mutex_->mutex);
+    snapshot_.readers_.push_back(epoch_);
+    pthread_mutex_unlock(&snapshot_.mutex_->mutex);
+}
+
+Snapshot::Reader::~Reader() {
+    pthread_mutex_lock(&snapshot_.mutex_->mutex);
+    snapshot_.readers_.remove(epoch_);
+    pthread_mutex_unlock(&snapshot_.mutex_->mutex);
+    ::free(epoch_);
+}
+
+const blet::Dict& Snapshot::Reader::lock() {
+    if (nested_ == 0) {
+        // announce the epoch before load the document
+        __atomic_store_n(epoch_, __atomic_load_n(&snapshot_.epoch_, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+        document_ = __atomic_load_n(&snapshot_.current_, __ATOMIC_SEQ_CST);
+    }
+    ++nested_;
+    return document_->dict;
+}
+
+void Snapshot::Reader::unlock() {
+    --nested_;
+    if (nested_ == 0) {
+        document_ = NULL;
+        __atomic_store_n(epoch_, 0, __ATOMIC_SEQ_CST);
+    }
+}
+
+unsigned long Snapshot::Reader::version() const {
+    if (document_ == NULL) {
+        return 0;
+    }
+    return document_->version;
+}
+
+Snapshot::Snapshot() :
+    current_(new Document(0)),
+    epoch_(1),
+    version_(0),
+    readers_(),
+    retired_(),
+    mutex_(new Mutex()) {}
+
+Snapshot::~Snapshot() {
+    for (std::list<Document*>::iterator it = retired_.begin(); it != retired_.end(); ++it) {
+        delete *it;
+    }
+    delete current_;
+    delete mutex_;
+}
+
+void Snapshot::publish(blet::Dict& dict) {
+    pthread_mutex_lock(&mutex_->mutex);
+    Document* document = new Document(version_ + 1);
+    document->dict.swap(dict);
+    Document* old = __atomic_exchange_n(&current_, document, __ATOMIC_SEQ_CST);
+    // readers with a epoch lower or equal can use the old document
+    old->epoch = __atomic_fetch_add(&epoch_, 1, __ATOMIC_SEQ_CST);
+    retired_.push_back(old);
+    __atomic_store_n(&version_, document->version, __ATOMIC_SEQ_CST);
+    reclaimLocked();
+    pthread_mutex_unlock(&mutex_->mutex);
+}
+
+std::size_t Snapshot::reclaim() {
+    pthread_mutex_lock(&mutex_->mutex);
+    std::size_t ret = reclaimLocked();
+    pthread_mutex_unlock(&mutex_->mutex);
+    return ret;
+}
+
+unsigned long Snapshot::version() const {
+    return __atomic_load_n(&version_, __ATOMIC_SEQ_CST);
+}
+
+std::size_t Snapshot::reclaimLocked() {
+    // get the minimum epoch of active readers
+    unsigned long minEpoch = 0;
+    for (std::list<unsigned long*>::const_iterator cit = readers_.begin(); cit != readers_.end(); ++cit) {
+        unsigned long epoch = __atomic_load_n(*cit, __ATOMIC_SEQ_CST);
+        if (epoch != 0 && (minEpoch == 0 || epoch < minEpoch)) {
+            minEpoch = epoch;
+        }
+    }
+    std::list<Document*>::iterator it = retired_.begin();
+    while (it != retired_.end()) {
+        if (minEpoch == 0 || (*it)->epoch < minEpoch) {
+            delete *it;
+            it = retired_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    return retired_.size();
+}
+
+} // namespace conf
+
+} // namespace blet
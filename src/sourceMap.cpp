@@ -0,0 +1,157 @@
+/**
+ * sourceMap.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string.h>
+
+#include <algorithm> // std::find, std::upper_bound
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+static const std::size_t s_noIndex = static_cast<std::size_t>(-1);
+
+SourceMap::SourceMap() :
+    parents_(),
+    keys_(),
+    indexes_(),
+    offsets_(),
+    files_(),
+    filenames_(),
+    lineStarts_() {}
+
+SourceMap::~SourceMap() {}
+
+void SourceMap::clear() {
+    parents_.clear();
+    keys_.clear();
+    indexes_.clear();
+    offsets_.clear();
+    files_.clear();
+    filenames_.clear();
+    lineStarts_.clear();
+}
+
+bool SourceMap::find(const std::string& path, Location& location) const {
+    Accessor accessor(path.c_str());
+    const std::vector<Accessor::Segment>& segments = accessor.segments_;
+    if (segments.empty()) {
+        return false;
+    }
+    // the last record of path is the last assignment
+    for (std::size_t i = parents_.size(); i > 0; --i) {
+        std::size_t record = i - 1;
+        std::size_t segment = segments.size();
+        while (segment > 0 && record != s_noIndex) {
+            const Accessor::Segment& current = segments[segment - 1];
+            if (current.isIndex ? indexes_[record] != current.index
+                                : (indexes_[record] != s_noIndex || keys_[record] != current.key)) {
+                break;
+            }
+            record = parents_[record];
+            --segment;
+        }
+        if (segment == 0 && record == s_noIndex) {
+            this->location(i - 1, location);
+            return true;
+        }
+    }
+    return false;
+}
+
+LoadException SourceMap::locate(const std::string& path, const std::string& message) const {
+    Location location;
+    if (find(path, location)) {
+        return LoadException(location.filename, location.line, location.column, message);
+    }
+    return LoadException("", message);
+}
+
+std::size_t SourceMap::addFile(const std::string& filename, const char* content, std::size_t size) {
+    filenames_.push_back(filename);
+    lineStarts_.push_back(std::vector<std::size_t>());
+    std::vector<std::size_t>& lineStarts = lineStarts_.back();
+    lineStarts.push_back(0);
+    const char* begin = content;
+    const char* end = begin + size;
+    for (const char* ptr = begin; (ptr = static_cast<const char*>(::memchr(ptr, '\n', end - ptr))) != NULL;) {
+        ++ptr;
+        lineStarts.push_back(ptr - begin);
+    }
+    return filenames_.size() - 1;
+}
+
+std::size_t SourceMap::add(std::size_t parent, const std::string& key, std::size_t offset, std::size_t file) {
+    parents_.push_back(parent);
+    keys_.push_back(key);
+    indexes_.push_back(s_noIndex);
+    offsets_.push_back(offset);
+    files_.push_back(file);
+    return parents_.size() - 1;
+}
+
+std::size_t SourceMap::add(std::size_t parent, std::size_t index, std::size_t offset, std::size_t file) {
+    parents_.push_back(parent);
+    keys_.push_back(std::string());
+    indexes_.push_back(index);
+    offsets_.push_back(offset);
+    files_.push_back(file);
+    return parents_.size() - 1;
+}
+
+void SourceMap::location(std::size_t record, Location& location) const {
+    const std::vector<std::size_t>& lineStarts = lineStarts_[files_[record]];
+    std::size_t line = std::upper_bound(lineStarts.begin(), lineStarts.end(), offsets_[record]) - lineStarts.begin();
+    location.filename = filenames_[files_[record]];
+    location.offset = offsets_[record];
+    location.line = line;
+    location.column = offsets_[record] - lineStarts[line - 1] + 1;
+}
+
+void SourceMap::append(const SourceMap& sourceMap, std::size_t parent, const std::vector<std::size_t>& indexShifts) {
+    std::vector<std::size_t> files(sourceMap.filenames_.size());
+    for (std::size_t i = 0; i < sourceMap.filenames_.size(); ++i) {
+        files[i] = std::find(filenames_.begin(), filenames_.end(), sourceMap.filenames_[i]) - filenames_.begin();
+        if (files[i] == filenames_.size()) {
+            filenames_.push_back(sourceMap.filenames_[i]);
+            lineStarts_.push_back(sourceMap.lineStarts_[i]);
+        }
+    }
+    // the records of first level are attached to parent
+    std::size_t first = parents_.size();
+    for (std::size_t i = 0; i < sourceMap.parents_.size(); ++i) {
+        parents_.push_back(sourceMap.parents_[i] == s_noIndex ? parent : sourceMap.parents_[i] + first);
+        keys_.push_back(sourceMap.keys_[i]);
+        indexes_.push_back(sourceMap.indexes_[i] == s_noIndex ? s_noIndex : sourceMap.indexes_[i] + indexShifts[i]);
+        offsets_.push_back(sourceMap.offsets_[i]);
+        files_.push_back(files[sourceMap.files_[i]]);
+    }
+}
+
+} // namespace conf
+
+} // namespace blet
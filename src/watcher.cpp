@@ -0,0 +1,228 @@
+/**
+ * watcher.cpp
+ *
+ * Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+ * Copyright (c) 2024 BLET Mickaël.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <algorithm> // std::find
+
+#include "blet/conf.h"
+
+namespace blet {
+
+namespace conf {
+
+static std::string s_dirname(const std::string& filename) {
+    std::size_t pos = filename.rfind('/');
+    if (pos == std::string::npos) {
+        return ".";
+    }
+    if (pos == 0) {
+        return "/";
+    }
+    return filename.substr(0, pos);
+}
+
+static std::string s_basename(const std::string& filename) {
+    std::size_t pos = filename.rfind('/');
+    if (pos == std::string::npos) {
+        return filename;
+    }
+    return filename.substr(pos + 1);
+}
+
+/**
+ * @brief Background thread of watcher.
+ */
+struct Watcher::Thread {
+    pthread_t thread;
+};
+
+Watcher::Watcher(const char* filename, Snapshot& snapshot, Listener* listener, std::size_t debounce,
+                 const LoadOptions& options) :
+    filename_(filename),
+    filenames_(),
+    snapshot_(snapshot),
+    listener_(listener),
+    debounce_(debounce),
+    options_(options),
+    inotifyFd_(-1),
+    watches_(),
+    thread_(new Thread()),
+    running_(false) {
+    stopFds_[0] = -1;
+    stopFds_[1] = -1;
+    filenames_.push_back(filename_);
+}
+
+Watcher::~Watcher() {
+    stop();
+    delete thread_;
+}
+
+void Watcher::watch(const char* filename) {
+    filenames_.push_back(filename);
+}
+
+void Watcher::start() {
+    if (running_) {
+        return;
+    }
+    // watch before the first load for not miss a change during the load
+    inotifyFd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        throw LoadException(filename_, "Watch file failed");
+    }
+    try {
+        // watch the directories for catch the write and rename of editors
+        watches_.clear();
+        for (std::list<std::string>::const_iterator cit = filenames_.begin(); cit != filenames_.end(); ++cit) {
+            // the same directory returns the same watch descriptor
+            int wd = ::inotify_add_watch(inotifyFd_, s_dirname(*cit).c_str(),
+                                         IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE);
+            if (wd < 0) {
+                throw LoadException(*cit, "Watch file failed");
+            }
+            watches_[wd].push_back(s_basename(*cit));
+        }
+        if (::pipe(stopFds_) != 0) {
+            throw LoadException(filename_, "Watch file failed");
+        }
+        blet::Dict dict = loadFile(filename_.c_str(), options_);
+        snapshot_.publish(dict);
+        if (listener_ != NULL) {
+            listener_->onReload(snapshot_.version());
+        }
+        if (pthread_create(&thread_->thread, NULL, &s_run, this) != 0) {
+            throw LoadException(filename_, "Watch file failed");
+        }
+    }
+    catch (...) {
+        closeFds();
+        throw;
+    }
+    running_ = true;
+}
+
+void Watcher::stop() {
+    if (!running_) {
+        return;
+    }
+    char stop = 0;
+    while (::write(stopFds_[1], &stop, 1) < 0 && errno == EINTR) {
+    }
+    pthread_join(thread_->thread, NULL);
+    closeFds();
+    running_ = false;
+}
+
+void Watcher::closeFds() {
+    ::close(inotifyFd_);
+    inotifyFd_ = -1;
+    if (stopFds_[0] != -1) {
+        ::close(stopFds_[0]);
+        ::close(stopFds_[1]);
+        stopFds_[0] = -1;
+        stopFds_[1] = -1;
+    }
+}
+
+void Watcher::reload() {
+    try {
+        blet::Dict dict = loadFile(filename_.c_str(), options_);
+        snapshot_.publish(dict);
+        if (listener_ != NULL) {
+            listener_->onReload(snapshot_.version());
+        }
+    }
+    catch (const LoadException& e) {
+        if (listener_ != NULL) {
+            listener_->onError(e);
+        }
+    }
+    // keep the thread alive on the others exceptions (allocation or listener)
+    catch (const std::exception& e) {
+        if (listener_ != NULL) {
+            listener_->onError(LoadException(filename_, e.what()));
+        }
+    }
+    catch (...) {
+        if (listener_ != NULL) {
+            listener_->onError(LoadException(filename_, "Reload failed"));
+        }
+    }
+}
+
+void Watcher::run() {
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool pending = false;
+    while (true) {
+        struct pollfd fds[2];
+        fds[0].fd = stopFds_[0];
+        fds[0].events = POLLIN;
+        fds[1].fd = inotifyFd_;
+        fds[1].events = POLLIN;
+        int ret;
+        while ((ret = ::poll(fds, 2, pending ? static_cast<int>(debounce_) : -1)) < 0 && errno == EINTR) {
+        }
+        if (ret < 0 || fds[0].revents != 0) {
+            break; // stop
+        }
+        if (ret == 0) {
+            // no event during the debounce delay
+            pending = false;
+            reload();
+            continue;
+        }
+        ssize_t size;
+        while ((size = ::read(inotifyFd_, buffer, sizeof(buffer))) > 0) {
+            for (char* ptr = buffer; ptr < buffer + size;) {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+                if (event->len > 0 && isWatched(event->wd, event->name)) {
+                    pending = true;
+                }
+                ptr += sizeof(struct inotify_event) + event->len;
+            }
+        }
+    }
+}
+
+bool Watcher::isWatched(int wd, const char* name) const {
+    std::map<int, std::list<std::string> >::const_iterator cit = watches_.find(wd);
+    return cit != watches_.end() && std::find(cit->second.begin(), cit->second.end(), name) != cit->second.end();
+}
+
+void* Watcher::s_run(void* watcher) {
+    static_cast<Watcher*>(watcher)->run();
+    return NULL;
+}
+
+} // namespace conf
+
+} // namespace blet
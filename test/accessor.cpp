@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <sstream>
+
+#include "blet/conf.h"
+
+GTEST_TEST(accessor, except_compile) {
+    EXPECT_THROW(blet::conf::compile("foo."), std::invalid_argument);
+    EXPECT_THROW(blet::conf::compile(".foo"), std::invalid_argument);
+    EXPECT_THROW(blet::conf::compile("foo[]"), std::invalid_argument);
+    EXPECT_THROW(blet::conf::compile("foo[a]"), std::invalid_argument);
+    EXPECT_THROW(blet::conf::compile("foo[0"), std::invalid_argument);
+    EXPECT_THROW(blet::conf::compile("foo.\"bar"), std::invalid_argument);
+    EXPECT_THROW(blet::conf::compile("foo\"bar\""), std::invalid_argument);
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::compile("foo..bar");
+            }
+            catch (const std::invalid_argument& e) {
+                EXPECT_STREQ(e.what(), "Invalid path \"foo..bar\" at column 5");
+                throw;
+            }
+        },
+        std::invalid_argument);
+    // index overflow
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::compile("a[99999999999999999999]");
+            }
+            catch (const std::invalid_argument& e) {
+                EXPECT_STREQ(e.what(), "Invalid path \"a[99999999999999999999]\" at column 22");
+                throw;
+            }
+        },
+        std::invalid_argument);
+    std::ostringstream oss("");
+    oss << "a[" << std::numeric_limits<std::size_t>::max() << "]";
+    EXPECT_EQ(blet::conf::compile(oss.str().c_str()).path(), oss.str());
+}
+
+GTEST_TEST(accessor, bind) {
+    blet::Dict conf = blet::conf::loadString(
+        "[foo]\n"
+        "[[nextLevel]]\n"
+        "bar=42\n"
+        "array=[1, 2, 3]\n"
+        "\"a.b\"=\"quoted\"\n");
+
+    blet::conf::Accessor bar = blet::conf::compile("foo.nextLevel.bar");
+    EXPECT_EQ(bar.get(), static_cast<const blet::Dict*>(NULL));
+    ASSERT_EQ(bar.bind(conf), &conf["foo"]["nextLevel"]["bar"]);
+    EXPECT_EQ(*bar, 42);
+
+    blet::conf::Accessor array = blet::conf::compile("foo.nextLevel.array[2]");
+    array.bind(conf);
+    EXPECT_EQ(*array, 3);
+
+    blet::conf::Accessor quoted = blet::conf::compile("foo.nextLevel.\"a.b\"");
+    quoted.bind(conf);
+    EXPECT_EQ(*quoted, "quoted");
+
+    blet::conf::Accessor root;
+    EXPECT_EQ(root.bind(conf), &conf);
+
+    blet::conf::Accessor notFound = blet::conf::compile("foo.nextLevel.array[3]");
+    EXPECT_EQ(notFound.bind(conf), static_cast<const blet::Dict*>(NULL));
+    EXPECT_THROW(*notFound, std::out_of_range);
+    blet::conf::Accessor notObject = blet::conf::compile("foo.nextLevel.bar.baz");
+    EXPECT_EQ(notObject.bind(conf), static_cast<const blet::Dict*>(NULL));
+}
+
+GTEST_TEST(accessor, append) {
+    std::string path;
+    blet::conf::Accessor::appendKey(path, "foo");
+    blet::conf::Accessor::appendIndex(path, 0);
+    blet::conf::Accessor::appendKey(path, "a.b");
+    blet::conf::Accessor::appendKey(path, "quo\"te\\");
+    blet::conf::Accessor::appendKey(path, "");
+    blet::conf::Accessor::appendIndex(path, 12);
+    EXPECT_EQ(path, "foo[0].\"a.b\".\"quo\\\"te\\\\\".\"\"[12]");
+
+    // the appended path is compiled to the same keys
+    blet::Dict conf;
+    conf["foo"][0]["a.b"]["quo\"te\\"][""][12] = 42;
+    blet::conf::Accessor accessor = blet::conf::compile(path.c_str());
+    EXPECT_EQ(*accessor.bind(conf), 42);
+
+    path.clear();
+    blet::conf::Accessor::appendIndex(path, 1);
+    blet::conf::Accessor::appendKey(path, "bar");
+    EXPECT_EQ(path, "[1].bar");
+}
+
+GTEST_TEST(accessor, bind_snapshot) {
+    blet::conf::Snapshot snapshot;
+    blet::conf::Snapshot::Reader reader(snapshot);
+    blet::conf::Accessor foo = blet::conf::compile("foo");
+
+    blet::Dict conf = blet::conf::loadString("foo=42");
+    snapshot.publish(conf);
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_EQ(*foo.bind(guard), 42);
+        const blet::Dict* node = foo.get();
+        // same version keep the node
+        EXPECT_EQ(foo.bind(guard), node);
+    }
+
+    conf = blet::conf::loadString("foo=24");
+    snapshot.publish(conf);
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_EQ(*foo.bind(guard), 24);
+    }
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include "blet/conf.h"
+
+struct Server {
+    std::string host;
+    unsigned short port;
+    bool secure;
+    double timeout;
+    std::vector<std::string> aliases;
+};
+
+struct Config {
+    Server server;
+    int workers;
+    blet::Dict extra;
+};
+
+GTEST_TEST(binding, bind) {
+    blet::Dict conf = blet::conf::loadString(
+        "workers=4\n"
+        "[server]\n"
+        "host=localhost\n"
+        "port=8080\n"
+        "secure=true\n"
+        "aliases=[foo, bar]\n"
+        "[extra]\n"
+        "foo=bar\n");
+
+    blet::conf::Binding<Server> serverBinding;
+    serverBinding.field("host", &Server::host)
+        .field("port", &Server::port)
+        .field("secure", &Server::secure)
+        .field("timeout", &Server::timeout, false)
+        .field("aliases", &Server::aliases);
+    blet::conf::Binding<Config> binding;
+    binding.field("server", &Config::server, serverBinding)
+        .field("workers", &Config::workers)
+        .field("extra", &Config::extra);
+
+    Config config;
+    config.server.timeout = 1.5;
+    binding.bind(conf, config);
+    EXPECT_EQ(config.server.host, "localhost");
+    EXPECT_EQ(config.server.port, 8080);
+    EXPECT_EQ(config.server.secure, true);
+    EXPECT_EQ(config.server.timeout, 1.5);
+    ASSERT_EQ(config.server.aliases.size(), 2u);
+    EXPECT_EQ(config.server.aliases[0], "foo");
+    EXPECT_EQ(config.server.aliases[1], "bar");
+    EXPECT_EQ(config.workers, 4);
+    EXPECT_EQ(config.extra["foo"], "bar");
+}
+
+GTEST_TEST(binding, except_bind) {
+    blet::Dict conf = blet::conf::loadString(
+        "workers=4.5\n"
+        "[server]\n"
+        "port=80000\n"
+        "secure=\"true\"\n"
+        "aliases=[foo, 42]\n");
+
+    blet::conf::Binding<Server> serverBinding;
+    serverBinding.field("host", &Server::host)
+        .field("port", &Server::port)
+        .field("secure", &Server::secure)
+        .field("aliases", &Server::aliases);
+    blet::conf::Binding<Config> binding;
+    binding.field("server", &Config::server, serverBinding).field("workers", &Config::workers);
+
+    Config config;
+    EXPECT_THROW(
+        {
+            try {
+                binding.bind(conf, config);
+            }
+            catch (const blet::conf::BindException& e) {
+                ASSERT_EQ(e.errors().size(), 5u);
+                EXPECT_EQ(e.errors()[0].message(), "server.host: is not found");
+                EXPECT_EQ(e.errors()[1].message(), "server.port: is out of range");
+                EXPECT_EQ(e.errors()[2].message(), "server.secure: is not a boolean (is string)");
+                EXPECT_EQ(e.errors()[3].message(), "server.aliases[1]: is not a string (is number)");
+                EXPECT_EQ(e.errors()[4].message(), "workers: is not a integer");
+                EXPECT_STREQ(e.what(),
+                             "Bind (server.host: is not found, server.port: is out of range, server.secure: is not a "
+                             "boolean (is string), server.aliases[1]: is not a string (is number), workers: is not a "
+                             "integer)");
+                throw;
+            }
+        },
+        blet::conf::BindException);
+}
+
+struct Matrix {
+    std::vector<std::vector<int> > cells;
+};
+
+GTEST_TEST(binding, except_bind_element) {
+    blet::Dict conf;
+    conf["a.b"][0][0] = 1;
+    conf["a.b"][1][0] = 2;
+    conf["a.b"][1][1] = "x";
+
+    blet::conf::Binding<Matrix> binding;
+    binding.field("\"a.b\"", &Matrix::cells);
+
+    Matrix matrix;
+    EXPECT_THROW(
+        {
+            try {
+                binding.bind(conf, matrix);
+            }
+            catch (const blet::conf::BindException& e) {
+                ASSERT_EQ(e.errors().size(), 1u);
+                EXPECT_EQ(e.errors()[0].message(), "\"a.b\"[1][1]: is not a number (is string)");
+                throw;
+            }
+        },
+        blet::conf::BindException);
+}
+
+struct Limits {
+    long integer64;
+    unsigned long unsigned64;
+    int integer32;
+};
+
+GTEST_TEST(binding, limits) {
+    blet::conf::Binding<Limits> binding;
+    binding.field("integer64", &Limits::integer64)
+        .field("unsigned64", &Limits::unsigned64)
+        .field("integer32", &Limits::integer32);
+
+    // largest doubles below the exclusive bounds
+    blet::Dict conf;
+    conf["integer64"] = std::ldexp(1.0, 63) - 1024;
+    conf["unsigned64"] = std::ldexp(1.0, 64) - 2048;
+    conf["integer32"] = std::ldexp(1.0, 31) - 1;
+    Limits limits;
+    binding.bind(conf, limits);
+    EXPECT_EQ(limits.integer64, 9223372036854774784L);
+    EXPECT_EQ(limits.unsigned64, 18446744073709549568UL);
+    EXPECT_EQ(limits.integer32, 2147483647);
+
+    conf["integer64"] = -std::ldexp(1.0, 63);
+    conf["unsigned64"] = 0;
+    conf["integer32"] = -std::ldexp(1.0, 31);
+    binding.bind(conf, limits);
+    EXPECT_EQ(limits.integer64, std::numeric_limits<long>::min());
+    EXPECT_EQ(limits.unsigned64, 0u);
+    EXPECT_EQ(limits.integer32, std::numeric_limits<int>::min());
+
+    // the max of 64 bits as a double is out of range
+    conf["integer64"] = std::ldexp(1.0, 63);
+    conf["unsigned64"] = std::ldexp(1.0, 64);
+    conf["integer32"] = std::ldexp(1.0, 31);
+    EXPECT_THROW(
+        {
+            try {
+                binding.bind(conf, limits);
+            }
+            catch (const blet::conf::BindException& e) {
+                ASSERT_EQ(e.errors().size(), 3u);
+                EXPECT_EQ(e.errors()[0].message(), "integer64: is out of range");
+                EXPECT_EQ(e.errors()[1].message(), "unsigned64: is out of range");
+                EXPECT_EQ(e.errors()[2].message(), "integer32: is out of range");
+                throw;
+            }
+        },
+        blet::conf::BindException);
+
+    conf["integer64"] = -std::ldexp(1.0, 63) - 2048;
+    conf["unsigned64"] = -1;
+    conf["integer32"] = -std::ldexp(1.0, 31) - 1;
+    EXPECT_THROW(binding.bind(conf, limits), blet::conf::BindException);
+}
@@ -1,4 +1,10 @@
 #include <gtest/gtest.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <locale>
+#include <stdexcept>
 
 #include "blet/conf.h"
 
@@ -222,3 +228,384 @@ GTEST_TEST(dump, escape_character) {
         EXPECT_EQ(blet::conf::dump(dict, 2, ' ', blet::conf::JSON_STYLE), resultStr);
     }
 }
+
+GTEST_TEST(dump, compact_indent) {
+    {
+        std::vector<int> v;
+        v.push_back(1);
+        v.push_back(2);
+        blet::Dict dict;
+        dict["section"]["arr"][0] = v;
+        dict["section"]["obj"]["foo"] = "b\tar";
+        dict["section"]["obj"]["bar"] = v;
+        dict["section"]["obj"]["empty"] = std::map<std::string, int>();
+        dict["section"]["str"] = "foo";
+        // clang-format off
+        const char resultStr[] = ""
+            "[section]\n"
+            "arr[]=[1,2]\n"
+            "str=\"foo\"\n"
+            "[[obj]]\n"
+            "bar[]=1\n"
+            "bar[]=2\n"
+            "foo=\"b\\tar\"\n"
+            "empty={}";
+        // clang-format on
+        EXPECT_EQ(blet::conf::dump(dict), resultStr);
+    }
+    {
+        std::vector<int> v;
+        v.push_back(1);
+        v.push_back(2);
+        blet::Dict dict;
+        dict["section"]["arr"][0] = v;
+        dict["section"]["obj"]["foo"] = "b\tar";
+        // clang-format off
+        const char resultStr[] = ""
+            "section={arr=[[1,2]],obj={foo=\"b\\tar\"}}";
+        // clang-format on
+        EXPECT_EQ(blet::conf::dump(dict, 0, ' ', blet::conf::JSON_STYLE), resultStr);
+    }
+}
+
+GTEST_TEST(dump, parallel_dump) {
+    blet::Dict dict;
+    dict["foo"] = 42;
+    dict["bar"][0] = "bar";
+    dict["bar"][1] = 0.5;
+    dict["empty"] = std::map<std::string, int>();
+    for (std::size_t i = 0; i < 16; ++i) {
+        std::ostringstream oss("");
+        oss << "section" << i;
+        dict[oss.str()]["key"] = i;
+        dict[oss.str()]["sub"]["arr"][0] = "val\tue";
+        dict[oss.str()]["sub"]["arr"][1] = true;
+    }
+    for (std::size_t indent = 0; indent < 3; ++indent) {
+        EXPECT_EQ(blet::conf::parallelDump(dict, indent, ' ', blet::conf::CONF_STYLE, 4),
+                  blet::conf::dump(dict, indent, ' ', blet::conf::CONF_STYLE));
+        EXPECT_EQ(blet::conf::parallelDump(dict, indent, ' ', blet::conf::JSON_STYLE, 4),
+                  blet::conf::dump(dict, indent, ' ', blet::conf::JSON_STYLE));
+    }
+    // not a object
+    blet::Dict number = 42;
+    EXPECT_EQ(blet::conf::parallelDump(number), "42");
+}
+
+GTEST_TEST(dump, parallel_dump_threads) {
+    blet::Dict dict;
+    dict["foo"]["key"] = 42;
+    dict["bar"]["key"] = "bar";
+    const std::string result = blet::conf::dump(dict, 2);
+    // more threads than sections
+    EXPECT_EQ(blet::conf::parallelDump(dict, 2, ' ', blet::conf::CONF_STYLE, 64), result);
+}
+
+#ifdef __GLIBC__
+
+/**
+ * @brief Restore the default attributes of threads changed by a test (glibc only).
+ */
+class dumpDefaultThreadAttr : public ::testing::Test {
+  protected:
+    void SetUp() {
+        ASSERT_EQ(::pthread_getattr_default_np(&attr_), 0);
+    }
+
+    void TearDown() {
+        ::pthread_setattr_default_np(&attr_);
+        ::pthread_attr_destroy(&attr_);
+    }
+
+    /**
+     * @brief Set a default stack larger than any address space, the next threads are not created.
+     */
+    void setStackTooLarge() {
+        pthread_attr_t largeAttr;
+        ASSERT_EQ(::pthread_getattr_default_np(&largeAttr), 0);
+        ASSERT_EQ(::pthread_attr_setstacksize(&largeAttr, static_cast<std::size_t>(1) << 62), 0);
+        ASSERT_EQ(::pthread_setattr_default_np(&largeAttr), 0);
+        ::pthread_attr_destroy(&largeAttr);
+    }
+
+    pthread_attr_t attr_;
+};
+
+TEST_F(dumpDefaultThreadAttr, parallel_dump_create_failed) {
+    blet::Dict dict;
+    dict["foo"]["key"] = 42;
+    dict["bar"]["key"] = "bar";
+    setStackTooLarge();
+    // the current thread takes the tasks of the workers not created
+    EXPECT_EQ(blet::conf::parallelDump(dict, 2, ' ', blet::conf::CONF_STYLE, 4), blet::conf::dump(dict, 2));
+}
+
+#endif
+
+class ThrowNumPut : public std::num_put<char> {
+  protected:
+    iter_type do_put(iter_type, std::ios_base&, char_type, double) const {
+        throw std::runtime_error("num_put");
+    }
+};
+
+GTEST_TEST(dump, except_parallel_dump) {
+    blet::Dict dict;
+    for (std::size_t i = 0; i < 8; ++i) {
+        std::ostringstream oss("");
+        oss << "section" << i;
+        dict[oss.str()]["key"] = i;
+    }
+    // the failed sections are rendered again by the caller
+    std::ostringstream oss("");
+    oss.imbue(std::locale(std::locale::classic(), new ThrowNumPut()));
+    oss.exceptions(std::ios::badbit);
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::parallelDump(dict, oss, 2, ' ', blet::conf::CONF_STYLE, 4);
+            }
+            catch (const std::runtime_error& e) {
+                EXPECT_STREQ(e.what(), "num_put");
+                throw;
+            }
+        },
+        std::runtime_error);
+
+    // without exceptions the stream is bad
+    std::ostringstream badOss("");
+    badOss.imbue(std::locale(std::locale::classic(), new ThrowNumPut()));
+    blet::conf::parallelDump(dict, badOss, 2, ' ', blet::conf::JSON_STYLE, 4);
+    EXPECT_TRUE(badOss.bad());
+}
+
+class ThreadSyncBuf : public std::streambuf {
+  public:
+    ThreadSyncBuf() :
+        std::streambuf(),
+        owner_(::pthread_self()),
+        foreign_(false) {}
+
+    bool foreign() const {
+        return foreign_;
+    }
+
+  protected:
+    int sync() {
+        if (!::pthread_equal(owner_, ::pthread_self())) {
+            foreign_ = true;
+        }
+        else {
+            // let the workers take the tasks
+            ::usleep(1000);
+        }
+        return 0;
+    }
+
+  private:
+    pthread_t owner_;
+    volatile bool foreign_;
+};
+
+GTEST_TEST(dump, parallel_dump_tie) {
+    blet::Dict dict;
+    for (std::size_t i = 0; i < 8; ++i) {
+        std::ostringstream oss("");
+        oss << "section" << i;
+        dict[oss.str()]["key"] = i;
+    }
+    ThreadSyncBuf buffer;
+    std::ostream tied(&buffer);
+    std::ostringstream oss("");
+    oss.tie(&tied);
+    blet::conf::parallelDump(dict, oss, 2, ' ', blet::conf::CONF_STYLE, 4);
+    EXPECT_EQ(oss.str(), blet::conf::dump(dict, 2));
+    // the tied stream is only flushed by the caller
+    EXPECT_FALSE(buffer.foreign());
+}
+
+GTEST_TEST(dump, append_string) {
+    blet::Dict dict;
+    dict["section"]["foo"] = "bar";
+    dict["section"]["large"] = std::string(1000, 'x');
+    const std::string result = blet::conf::dump(dict, 2);
+
+    std::string str("begin:");
+    blet::conf::dump(dict, str, 2);
+    EXPECT_EQ(str, "begin:" + result);
+
+    // reuse the capacity
+    str.clear();
+    const char* data = str.data();
+    blet::conf::dump(dict, str, 2);
+    EXPECT_EQ(str, result);
+    EXPECT_EQ(str.data(), data);
+
+    str.clear();
+    blet::conf::dump(dict, str, 2, ' ', blet::conf::JSON_STYLE);
+    EXPECT_EQ(str, blet::conf::dump(dict, 2, ' ', blet::conf::JSON_STYLE));
+    // grow a string without unused capacity
+    std::string full("begin:");
+    full.resize(full.capacity(), '-');
+    const std::string prefix = full;
+    blet::conf::DumpStats stats;
+    blet::conf::dump(dict, full, 0, ' ', blet::conf::CONF_STYLE, &stats);
+    EXPECT_EQ(full, prefix + blet::conf::dump(dict));
+    EXPECT_GT(stats.reallocations, 1u);
+}
+
+class LimitBuf : public std::streambuf {
+  public:
+    LimitBuf(std::size_t limit) :
+        std::streambuf(),
+        limit_(limit),
+        syncs_(0) {}
+
+    const std::string& str() const {
+        return str_;
+    }
+    std::size_t syncs() const {
+        return syncs_;
+    }
+
+  protected:
+    int_type overflow(int_type c) {
+        if (str_.size() >= limit_) {
+            return traits_type::eof();
+        }
+        str_.push_back(traits_type::to_char_type(c));
+        return c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) {
+        std::streamsize size = std::min(n, static_cast<std::streamsize>(limit_ - str_.size()));
+        str_.append(s, size);
+        return size;
+    }
+
+    int sync() {
+        ++syncs_;
+        return 0;
+    }
+
+  private:
+    std::size_t limit_;
+    std::size_t syncs_;
+    std::string str_;
+};
+
+GTEST_TEST(dump, stats_stream) {
+    blet::Dict dict;
+    dict["section"]["foo"] = "bar";
+    dict["section"]["number"] = 42;
+    const std::string result = blet::conf::dump(dict, 0);
+
+    // flushed after each output with unitbuf
+    LimitBuf buffer(result.size());
+    std::ostream os(&buffer);
+    os << std::unitbuf;
+    blet::conf::DumpStats stats;
+    blet::conf::dump(dict, os, 0, ' ', blet::conf::CONF_STYLE, &stats);
+    EXPECT_TRUE(os.good());
+    EXPECT_EQ(buffer.str(), result);
+    EXPECT_EQ(stats.bytes, result.size());
+    EXPECT_GT(buffer.syncs(), 0u);
+
+    // only the written bytes are counted
+    for (std::size_t limit = 0; limit < result.size(); ++limit) {
+        LimitBuf limitBuffer(limit);
+        std::ostream limitOs(&limitBuffer);
+        blet::conf::dump(dict, limitOs, 0, ' ', blet::conf::CONF_STYLE, &stats);
+        EXPECT_TRUE(limitOs.bad());
+        EXPECT_EQ(stats.bytes, limit);
+    }
+}
+
+GTEST_TEST(dump, stats) {
+    blet::Dict dict;
+    dict["a b"] = "x\ty";
+    dict["num"] = 42;
+    dict["flag"] = true;
+    dict["nothing"].newNull();
+    dict["list"].push_back(1);
+    dict["list"].push_back("s");
+    dict["section"]["k"] = 1;
+    dict["empty"].newObject();
+
+    for (int style = blet::conf::CONF_STYLE; style <= blet::conf::JSON_STYLE; ++style) {
+        blet::conf::DumpStats stats;
+        const std::string str = blet::conf::dump(dict, 2, ' ', static_cast<blet::conf::EDumpStyle>(style), &stats);
+        EXPECT_EQ(str, blet::conf::dump(dict, 2, ' ', static_cast<blet::conf::EDumpStyle>(style)));
+        EXPECT_EQ(stats.bytes, str.size());
+        EXPECT_EQ(stats.nodes[blet::Dict::NULL_TYPE], 1u);
+        EXPECT_EQ(stats.nodes[blet::Dict::BOOLEAN_TYPE], 1u);
+        EXPECT_EQ(stats.nodes[blet::Dict::NUMBER_TYPE], 3u);
+        EXPECT_EQ(stats.nodes[blet::Dict::STRING_TYPE], 2u);
+        EXPECT_EQ(stats.nodes[blet::Dict::ARRAY_TYPE], 1u);
+        EXPECT_EQ(stats.nodes[blet::Dict::OBJECT_TYPE], 3u);
+        EXPECT_EQ(stats.quotedKeys, 1u);
+        EXPECT_EQ(stats.escapedStrings, 1u);
+        EXPECT_GE(stats.numberTime, 0.0);
+        EXPECT_GE(stats.structureTime, 0.0);
+        EXPECT_GT(stats.reallocations, 0u);
+        EXPECT_EQ(stats.flushes, 0u);
+    }
+
+    // reuse the capacity
+    blet::conf::DumpStats stats;
+    std::string str;
+    str.reserve(1024);
+    blet::conf::dump(dict, str, 2, ' ', blet::conf::CONF_STYLE, &stats);
+    EXPECT_EQ(stats.bytes, str.size());
+    EXPECT_EQ(stats.reallocations, 0u);
+
+    // compact and stream
+    std::ostringstream oss("");
+    blet::conf::dump(dict, oss, 0, ' ', blet::conf::CONF_STYLE, &stats);
+    EXPECT_EQ(oss.str(), blet::conf::dump(dict));
+    EXPECT_EQ(stats.bytes, oss.str().size());
+    EXPECT_EQ(stats.nodes[blet::Dict::NUMBER_TYPE], 3u);
+    EXPECT_EQ(stats.reallocations, 0u);
+}
+
+GTEST_TEST(dump, policies) {
+    // escape and multiline values through the pretty, compact and stats dumpers
+    std::vector<blet::Dict> dicts;
+    dicts.push_back(blet::Dict());
+    dicts.push_back(false);
+    dicts.push_back(42);
+    dicts.push_back("\a\b\f\n\r\t\v\'\"\\");
+    dicts.push_back(blet::Dict());
+    dicts.back().push_back("first\nline");
+    dicts.back().push_back(false);
+    dicts.back().push_back(blet::Dict());
+    dicts.push_back(blet::Dict());
+    blet::Dict& object = dicts.back();
+    object["\a\b\f\n\r\t\v\'\"\\"] = "multi\nline\r\n";
+    object["a=b"]["c;d"] = false;
+    object["section"]["null"].newNull();
+    object["section"]["list"].push_back(true);
+    object["section"]["list"].push_back(false);
+    object["section"]["list"][2]["key"] = "v\ta\tl";
+    object["section"]["list"][3].push_back(1);
+    object["section"]["sub"]["foo bar"] = "baz";
+    object["section"]["empty"].newObject();
+    object["section"]["emptyList"].newArray();
+    object["list"].push_back("x\ny");
+
+    for (std::size_t i = 0; i < dicts.size(); ++i) {
+        for (int style = blet::conf::CONF_STYLE; style <= blet::conf::JSON_STYLE; ++style) {
+            for (std::size_t indent = 0; indent <= 4; indent += 4) {
+                blet::conf::DumpStats stats;
+                const std::string str = blet::conf::dump(dicts[i], indent, ' ',
+                                                         static_cast<blet::conf::EDumpStyle>(style), &stats);
+                EXPECT_EQ(str, blet::conf::dump(dicts[i], indent, ' ', static_cast<blet::conf::EDumpStyle>(style)));
+                EXPECT_EQ(stats.bytes, str.size());
+                if (dicts[i].isObject()) {
+                    // same config after a new load
+                    EXPECT_EQ(blet::conf::dump(blet::conf::loadString(str)), blet::conf::dump(dicts[i])) << str;
+                }
+            }
+        }
+    }
+}
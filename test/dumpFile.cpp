@@ -0,0 +1,290 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "blet/conf.h"
+#include "mock/fileGuard.h"
+
+static std::string s_readFile(const char* filename) {
+    std::ifstream ifs(filename);
+    std::ostringstream oss("");
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+GTEST_TEST(dumpFile, except_open_file) {
+    blet::Dict dict;
+    dict["section"]["foo"] = "bar";
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::dumpFile(dict, "/tmp/blet_test_dumpFile_not_exists/except_open_file.conf");
+            }
+            catch (const blet::conf::DumpException& e) {
+                EXPECT_STREQ(e.what(),
+                             "Dump /tmp/blet_test_dumpFile_not_exists/except_open_file.conf: (Open file failed)");
+                EXPECT_EQ(e.message(), "Open file failed");
+                EXPECT_EQ(e.filename(), "/tmp/blet_test_dumpFile_not_exists/except_open_file.conf");
+                throw;
+            }
+        },
+        blet::conf::DumpException);
+}
+
+GTEST_TEST(dumpFile, except_write) {
+    blet::Dict dict;
+    dict["section"]["foo"] = "bar";
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::dumpFd(dict, -1);
+            }
+            catch (const blet::conf::DumpException& e) {
+                EXPECT_STREQ(e.what(), "Dump (Write failed)");
+                EXPECT_EQ(e.message(), "Write failed");
+                EXPECT_EQ(e.filename(), "");
+                throw;
+            }
+        },
+        blet::conf::DumpException);
+
+    // large block written without copy
+    blet::Dict large = std::string(2 * 1024 * 1024, 'x');
+    EXPECT_THROW(blet::conf::dumpFd(large, -1), blet::conf::DumpException);
+
+    // character written in a full buffer
+    blet::Dict full = std::string(1024 * 1024 - 1, 'x');
+    EXPECT_THROW(blet::conf::dumpFd(full, -1), blet::conf::DumpException);
+}
+
+static std::string s_tmpFilename(const char* filename) {
+    std::ostringstream oss("");
+    oss << filename << '.' << ::getpid() << ".0.tmp";
+    return oss.str();
+}
+
+GTEST_TEST(dumpFile, except_write_file) {
+    const char* testFile = "/tmp/blet_test_dumpFile_except_write_file.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "old content" << std::flush;
+    fileGuard.close();
+
+    blet::Dict dict;
+    dict["section"]["foo"] = std::string(4096, 'x');
+
+    // size of file limit
+    ::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit limit;
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &limit), 0);
+    struct rlimit fileLimit = limit;
+    fileLimit.rlim_cur = 1024;
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &fileLimit), 0);
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::dumpFile(dict, testFile);
+            }
+            catch (const blet::conf::DumpException& e) {
+                EXPECT_STREQ(e.what(), "Dump /tmp/blet_test_dumpFile_except_write_file.conf: (Write failed)");
+                throw;
+            }
+        },
+        blet::conf::DumpException);
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limit), 0);
+    ::signal(SIGXFSZ, SIG_DFL);
+
+    // the replaced file is kept and the temporary file removed
+    EXPECT_EQ(s_readFile(testFile), "old content");
+    EXPECT_NE(::access(s_tmpFilename(testFile).c_str(), F_OK), 0);
+}
+
+GTEST_TEST(dumpFile, except_rename) {
+    const char* testDir = "/tmp/blet_test_dumpFile_except_rename";
+    ::mkdir(testDir, 0755);
+
+    blet::Dict dict;
+    dict["section"]["foo"] = "bar";
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::dumpFile(dict, testDir);
+            }
+            catch (const blet::conf::DumpException& e) {
+                EXPECT_STREQ(e.what(), "Dump /tmp/blet_test_dumpFile_except_rename: (Rename file failed)");
+                throw;
+            }
+        },
+        blet::conf::DumpException);
+    EXPECT_NE(::access(s_tmpFilename(testDir).c_str(), F_OK), 0);
+    ::rmdir(testDir);
+}
+
+GTEST_TEST(dumpFile, except_alloc) {
+    const char* testFile = "/tmp/blet_test_dumpFile_except_alloc.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "old content" << std::flush;
+    fileGuard.close();
+
+    blet::Dict dict;
+    dict["section"]["foo"] = "bar";
+
+    // size of address space limit for the buffer
+    std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    std::size_t pages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages;
+    struct rlimit limit;
+    ASSERT_EQ(::getrlimit(RLIMIT_AS, &limit), 0);
+    struct rlimit addressLimit = limit;
+    addressLimit.rlim_cur = pages * pageSize;
+    std::vector<void*> blocks;
+    blocks.reserve(1024);
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &addressLimit), 0);
+    // take the large free blocks of the heap
+    void* block;
+    while ((block = ::malloc(1024 * 1024)) != NULL) {
+        blocks.push_back(block);
+    }
+    EXPECT_THROW(blet::conf::dumpFile(dict, testFile), std::bad_alloc);
+    for (std::size_t i = 0; i < blocks.size(); ++i) {
+        ::free(blocks[i]);
+    }
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &limit), 0);
+
+    EXPECT_EQ(s_readFile(testFile), "old content");
+    EXPECT_NE(::access(s_tmpFilename(testFile).c_str(), F_OK), 0);
+}
+
+GTEST_TEST(dumpFile, valid) {
+    const char* testFile = "/tmp/blet_test_dumpFile_valid.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "old content" << std::flush;
+    fileGuard.close();
+    ::chmod(testFile, 0640);
+
+    blet::Dict dict;
+    dict["section"]["foo"] = "bar";
+    dict["section"]["number"] = 42;
+    blet::conf::dumpFile(dict, testFile, 2);
+    EXPECT_EQ(s_readFile(testFile), blet::conf::dump(dict, 2));
+
+    // keep the permissions of the replaced file
+    struct stat fileStat;
+    ASSERT_EQ(::stat(testFile, &fileStat), 0);
+    EXPECT_EQ(fileStat.st_mode & 07777, 0640u);
+}
+
+GTEST_TEST(dumpFile, large) {
+    const char* testFile = "/tmp/blet_test_dumpFile_large.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard.close();
+
+    // larger than the internal buffer
+    blet::Dict dict;
+    dict["large"] = std::string(3 * 1024 * 1024, 'x');
+    for (std::size_t i = 0; i < 10000; ++i) {
+        dict["array"][i] = i;
+    }
+    blet::conf::dumpFile(dict, testFile, 4, ' ', blet::conf::JSON_STYLE);
+    EXPECT_EQ(s_readFile(testFile), blet::conf::dump(dict, 4, ' ', blet::conf::JSON_STYLE));
+    // character written in a full buffer
+    blet::Dict full = std::string(1024 * 1024 - 1, 'x');
+    blet::conf::DumpStats stats;
+    blet::conf::dumpFile(full, testFile, 0, ' ', blet::conf::CONF_STYLE, &stats);
+    EXPECT_EQ(s_readFile(testFile), blet::conf::dump(full));
+    EXPECT_EQ(stats.flushes, 2u);
+}
+
+GTEST_TEST(dumpFile, fd) {
+    const char* testFile = "/tmp/blet_test_dumpFile_fd.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard.close();
+
+    blet::Dict dict;
+    dict["section"]["foo"] = "bar";
+    int fd = ::open(testFile, O_WRONLY | O_TRUNC);
+    ASSERT_GE(fd, 0);
+    blet::conf::dumpFd(dict, fd);
+    ::close(fd);
+    EXPECT_EQ(s_readFile(testFile), "[section]\nfoo=\"bar\"");
+
+    blet::conf::DumpStats stats;
+    blet::conf::dumpFile(dict, testFile, 0, ' ', blet::conf::CONF_STYLE, &stats);
+    EXPECT_EQ(s_readFile(testFile), "[section]\nfoo=\"bar\"");
+    EXPECT_EQ(stats.bytes, 19u);
+    EXPECT_EQ(stats.flushes, 1u);
+    EXPECT_EQ(stats.nodes[blet::Dict::OBJECT_TYPE], 2u);
+}
+
+struct PipeReader {
+    int fd;
+    std::string data;
+};
+
+static void* s_readPipe(void* arg) {
+    PipeReader* reader = static_cast<PipeReader*>(arg);
+    // let the writer block on the full pipe
+    ::usleep(100000);
+    char buffer[4096];
+    ssize_t ret;
+    while ((ret = ::read(reader->fd, buffer, sizeof(buffer))) > 0) {
+        reader->data.append(buffer, ret);
+    }
+    return NULL;
+}
+
+static void s_alarm(int /*signal*/) {}
+
+GTEST_TEST(dumpFile, interrupted) {
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+
+    // signal without restart of the interrupted writes
+    struct sigaction action;
+    struct sigaction oldAction;
+    ::memset(&action, 0, sizeof(action));
+    action.sa_handler = &s_alarm;
+    ::sigemptyset(&action.sa_mask);
+    ASSERT_EQ(::sigaction(SIGALRM, &action, &oldAction), 0);
+
+    // only the writer receives the signals
+    PipeReader reader;
+    reader.fd = fds[0];
+    sigset_t mask;
+    ::sigemptyset(&mask);
+    ::sigaddset(&mask, SIGALRM);
+    ::pthread_sigmask(SIG_BLOCK, &mask, NULL);
+    pthread_t thread;
+    ASSERT_EQ(::pthread_create(&thread, NULL, &s_readPipe, &reader), 0);
+    ::pthread_sigmask(SIG_UNBLOCK, &mask, NULL);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 10000;
+    timer.it_value = timer.it_interval;
+    ::setitimer(ITIMER_REAL, &timer, NULL);
+
+    blet::Dict dict = std::string(1024 * 1024, 'x');
+    blet::conf::DumpStats stats;
+    blet::conf::dumpFd(dict, fds[1], 0, ' ', blet::conf::CONF_STYLE, &stats);
+
+    ::memset(&timer, 0, sizeof(timer));
+    ::setitimer(ITIMER_REAL, &timer, NULL);
+    ::sigaction(SIGALRM, &oldAction, NULL);
+    ::close(fds[1]);
+    ::pthread_join(thread, NULL);
+    ::close(fds[0]);
+
+    // partial and interrupted writes are continued
+    EXPECT_EQ(reader.data, blet::conf::dump(dict));
+    EXPECT_GT(stats.flushes, 2u);
+}
@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "blet/conf.h"
+#include "mock/fileGuard.h"
+
+GTEST_TEST(include, valid) {
+    test::blet::FileGuard fragmentGuard("/tmp/blet_test_include_valid_fragment.conf",
+                                        std::ofstream::out | std::ofstream::trunc);
+    fragmentGuard << "host=localhost\n"
+                     "list[]=b\n"
+                     "[sub]\n"
+                     "foo=42\n"
+                  << std::flush;
+    fragmentGuard.close();
+    test::blet::FileGuard fileGuard("/tmp/blet_test_include_valid.conf", std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "[server]\n"
+                 "list[]=a\n"
+                 "@include \"blet_test_include_valid_fragment.conf\" # relative to this file\n"
+                 "@include /tmp/blet_test_include_valid_fragment.conf\n"
+                 "port=8080\n"
+                 "@include=key\n"
+              << std::flush;
+    fileGuard.close();
+
+    blet::conf::SourceMap sourceMap;
+    blet::conf::LoadOptions options;
+    options.sourceMap = &sourceMap;
+    blet::Dict conf = blet::conf::loadFile("/tmp/blet_test_include_valid.conf", options);
+    EXPECT_EQ(conf["server"]["host"], "localhost");
+    EXPECT_EQ(conf["server"]["port"], 8080);
+    EXPECT_EQ(conf["server"]["sub"]["foo"], 42);
+    EXPECT_EQ(conf["server"]["@include"], "key");
+    // the arrays of fragments are appended
+    ASSERT_EQ(conf["server"]["list"].size(), 3u);
+    EXPECT_EQ(conf["server"]["list"][0], "a");
+    EXPECT_EQ(conf["server"]["list"][1], "b");
+    EXPECT_EQ(conf["server"]["list"][2], "b");
+
+    blet::conf::SourceMap::Location location;
+    ASSERT_TRUE(sourceMap.find("server.sub.foo", location));
+    EXPECT_EQ(location.filename, "/tmp/blet_test_include_valid_fragment.conf");
+    EXPECT_EQ(location.line, 4u);
+    ASSERT_TRUE(sourceMap.find("server.port", location));
+    EXPECT_EQ(location.filename, "/tmp/blet_test_include_valid.conf");
+    EXPECT_EQ(location.line, 5u);
+}
+
+GTEST_TEST(include, appendSourceMap) {
+    test::blet::FileGuard fragmentGuard("/tmp/blet_test_include_appendSourceMap_fragment.conf",
+                                        std::ofstream::out | std::ofstream::trunc);
+    fragmentGuard << "a[]=y\n"
+                     "a[]=z\n"
+                     "b[]=w\n"
+                     "c[key][]=1\n"
+                     "c=overwritten\n"
+                     "[server]\n"
+                     "list[]=2\n"
+                  << std::flush;
+    fragmentGuard.close();
+    test::blet::FileGuard fileGuard("/tmp/blet_test_include_appendSourceMap.conf",
+                                    std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "a[]=x\n"
+                 "b=string\n"
+                 "[server]\n"
+                 "list[]=1\n"
+                 "[]\n"
+                 "@include \"blet_test_include_appendSourceMap_fragment.conf\"\n"
+              << std::flush;
+    fileGuard.close();
+
+    blet::conf::SourceMap sourceMap;
+    blet::conf::LoadOptions options;
+    options.sourceMap = &sourceMap;
+    blet::Dict conf = blet::conf::loadFile("/tmp/blet_test_include_appendSourceMap.conf", options);
+    ASSERT_EQ(conf["a"].size(), 3u);
+    EXPECT_EQ(conf["a"][0], "x");
+    EXPECT_EQ(conf["a"][1], "y");
+    EXPECT_EQ(conf["a"][2], "z");
+    ASSERT_EQ(conf["b"].size(), 1u);
+    EXPECT_EQ(conf["b"][0], "w");
+    ASSERT_EQ(conf["server"]["list"].size(), 2u);
+
+    // the indexes of fragment follow the elements of file
+    blet::conf::SourceMap::Location location;
+    ASSERT_TRUE(sourceMap.find("a[0]", location));
+    EXPECT_EQ(location.filename, "/tmp/blet_test_include_appendSourceMap.conf");
+    EXPECT_EQ(location.line, 1u);
+    ASSERT_TRUE(sourceMap.find("a[1]", location));
+    EXPECT_EQ(location.filename, "/tmp/blet_test_include_appendSourceMap_fragment.conf");
+    EXPECT_EQ(location.line, 1u);
+    ASSERT_TRUE(sourceMap.find("a[2]", location));
+    EXPECT_EQ(location.filename, "/tmp/blet_test_include_appendSourceMap_fragment.conf");
+    EXPECT_EQ(location.line, 2u);
+    EXPECT_FALSE(sourceMap.find("a[3]", location));
+    // a string replaced by the array of fragment
+    ASSERT_TRUE(sourceMap.find("b[0]", location));
+    EXPECT_EQ(location.filename, "/tmp/blet_test_include_appendSourceMap_fragment.conf");
+    EXPECT_EQ(location.line, 3u);
+    ASSERT_TRUE(sourceMap.find("server.list[0]", location));
+    EXPECT_EQ(location.filename, "/tmp/blet_test_include_appendSourceMap.conf");
+    EXPECT_EQ(location.line, 4u);
+    ASSERT_TRUE(sourceMap.find("server.list[1]", location));
+    EXPECT_EQ(location.filename, "/tmp/blet_test_include_appendSourceMap_fragment.conf");
+    EXPECT_EQ(location.line, 7u);
+    EXPECT_EQ(conf["c"], "overwritten");
+}
+
+GTEST_TEST(include, syntax) {
+    test::blet::FileGuard fragmentGuard("/tmp/blet_test_include syntax fragment.conf",
+                                        std::ofstream::out | std::ofstream::trunc);
+    fragmentGuard << "foo=42\n" << std::flush;
+    fragmentGuard.close();
+
+    blet::Dict conf = blet::conf::loadString(
+        "@key=value\n"
+        "@includes=value\n"
+        "[quote]\n"
+        "@include\"/tmp/blet_test_include syntax fragment.conf\"\n"
+        "[space]\n"
+        "@include /tmp/blet_test_include syntax fragment.conf ; comment\n");
+    EXPECT_EQ(conf["@key"], "value");
+    EXPECT_EQ(conf["@includes"], "value");
+    EXPECT_EQ(conf["quote"]["foo"], 42);
+    EXPECT_EQ(conf["space"]["foo"], 42);
+}
+
+GTEST_TEST(include, glob) {
+    test::blet::FileGuard firstGuard("/tmp/blet_test_include_glob_1.fragment", std::ofstream::out | std::ofstream::trunc);
+    firstGuard << "list[]=1\nfoo=1\n" << std::flush;
+    firstGuard.close();
+    test::blet::FileGuard secondGuard("/tmp/blet_test_include_glob_2.fragment",
+                                      std::ofstream::out | std::ofstream::trunc);
+    secondGuard << "list[]=2\nfoo=2\n" << std::flush;
+    secondGuard.close();
+
+    blet::Dict conf = blet::conf::loadString(
+        "@include /tmp/blet_test_include_glob_*.fragment\n"
+        "@include /tmp/blet_test_include_glob_not_found_*.fragment\n");
+    ASSERT_EQ(conf["list"].size(), 2u);
+    EXPECT_EQ(conf["list"][0], 1);
+    EXPECT_EQ(conf["list"][1], 2);
+    EXPECT_EQ(conf["foo"], 2);
+}
+
+GTEST_TEST(include, except_open_file) {
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::loadString("@include /tmp/blet_test_include_not_found.conf\n");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_STREQ(e.what(), "Load /tmp/blet_test_include_not_found.conf: (Open file failed)");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+}
+
+GTEST_TEST(include, except_open_socket) {
+    // a socket has a real path but can not be opened
+    const char socketPath[] = "/tmp/blet_test_include_except_open_socket.conf";
+    ::unlink(socketPath);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_NE(fd, -1);
+    struct sockaddr_un address;
+    ::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    ::strcpy(address.sun_path, socketPath);
+    ASSERT_EQ(::bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)), 0);
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::loadString("@include /tmp/blet_test_include_except_open_socket.conf\n");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_STREQ(e.what(), "Load /tmp/blet_test_include_except_open_socket.conf: (Open file failed)");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+    ::close(fd);
+    ::unlink(socketPath);
+}
+
+GTEST_TEST(include, except_path) {
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::loadString("@include \"\" # empty\n");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_STREQ(e.what(), "Load at 1:10 (Include path not found)");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+    // directory name too long
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::loadString("@include /tmp/" + std::string(512, 'a') + "/*.conf\n");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_STREQ(e.what(), "Load at 1:10 (Include glob failed)");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+    // a missing directory is not matched
+    EXPECT_TRUE(blet::conf::loadString("@include /tmp/blet_test_include_not_found/*.conf\n").isNull());
+}
+
+GTEST_TEST(include, except_cycle) {
+    test::blet::FileGuard firstGuard("/tmp/blet_test_include_cycle_1.conf", std::ofstream::out | std::ofstream::trunc);
+    firstGuard << "@include blet_test_include_cycle_2.conf\n" << std::flush;
+    firstGuard.close();
+    test::blet::FileGuard secondGuard("/tmp/blet_test_include_cycle_2.conf", std::ofstream::out | std::ofstream::trunc);
+    secondGuard << "foo=bar\n"
+                   "@include blet_test_include_cycle_1.conf\n"
+                << std::flush;
+    secondGuard.close();
+
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::loadFile("/tmp/blet_test_include_cycle_1.conf");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_STREQ(e.what(), "Load at /tmp/blet_test_include_cycle_2.conf:2:10 (Include cycle)");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+}
+
+GTEST_TEST(include, except_parsing) {
+    test::blet::FileGuard fragmentGuard("/tmp/blet_test_include_except_parsing_fragment.conf",
+                                        std::ofstream::out | std::ofstream::trunc);
+    fragmentGuard << "[section\n" << std::flush;
+    fragmentGuard.close();
+
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::loadString("@include '/tmp/blet_test_include_except_parsing_fragment.conf' foo\n");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_STREQ(e.what(), "Load at 1:64 (End of include)");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::loadString("@include '/tmp/blet_test_include_except_parsing_fragment.conf'\n");
+            }
+            catch (const blet::conf::LoadException& e) {
+                // the exception of fragment
+                EXPECT_EQ(e.filename(), "/tmp/blet_test_include_except_parsing_fragment.conf");
+                EXPECT_EQ(e.line(), 1u);
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+    EXPECT_THROW(blet::conf::loadString("@include /tmp/blet_test_include_except_parsing_fragment.con[f]\n"),
+                 blet::conf::LoadException);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "blet/conf.h"
+#include "mock/fileGuard.h"
+
+static blet::Dict s_loadInterpolation(const std::string& str) {
+    blet::conf::LoadOptions options;
+    options.interpolation = true;
+    return blet::conf::loadString(str, options);
+}
+
+GTEST_TEST(interpolation, disabled) {
+    blet::Dict conf = blet::conf::loadString("foo=${bar}\nbar=42\n");
+    EXPECT_EQ(conf["foo"], "${bar}");
+}
+
+GTEST_TEST(interpolation, valid) {
+    ::setenv("BLET_TEST_INTERPOLATION", "env", 1);
+    blet::Dict conf = s_loadInterpolation(
+        "url=\"http://${server.host}:${server.port}/${path}\"\n"
+        "path=${BLET_TEST_INTERPOLATION}/${server.name}\n"
+        "escape=\"$${server.host}\"\n"
+        "list[]=${server.port}\n"
+        "list[]=${server.secure}\n"
+        "[server]\n"
+        "host=localhost\n"
+        "port=8080\n"
+        "secure=true\n"
+        "name=${server.host}-name\n"
+        "alias=${server.name}\n");
+    EXPECT_EQ(conf["url"], "http://localhost:8080/env/localhost-name");
+    EXPECT_EQ(conf["path"], "env/localhost-name");
+    EXPECT_EQ(conf["escape"], "${server.host}");
+    // a alone reference keeps the type
+    EXPECT_EQ(conf["list"][0], 8080);
+    EXPECT_EQ(conf["list"][1], true);
+    EXPECT_EQ(conf["server"]["name"], "localhost-name");
+    EXPECT_EQ(conf["server"]["alias"], "localhost-name");
+}
+
+GTEST_TEST(interpolation, number) {
+    blet::Dict conf = s_loadInterpolation(
+        "integer=1500000\n"
+        "large=1234567890123\n"
+        "real=3.14159265\n"
+        "negative=-1234567.5\n"
+        "delay=\"${integer}us\"\n"
+        "id=\"id-${large}\"\n"
+        "pi=\"pi=${real}\"\n"
+        "offset=\"${negative}s\"\n");
+    EXPECT_EQ(conf["delay"], "1500000us");
+    EXPECT_EQ(conf["id"], "id-1234567890123");
+    EXPECT_EQ(conf["pi"], "pi=3.14159265");
+    EXPECT_EQ(conf["offset"], "-1234567.5s");
+}
+
+GTEST_TEST(interpolation, chain) {
+    blet::Dict conf = s_loadInterpolation(
+        "a=${b}-a\n"
+        "b=${c}-b\n"
+        "c=c\n"
+        "b=${c}-b2\n");
+    EXPECT_EQ(conf["a"], "c-b2-a");
+    EXPECT_EQ(conf["b"], "c-b2");
+}
+
+GTEST_TEST(interpolation, overwritten) {
+    blet::Dict conf = s_loadInterpolation(
+        "flag=v-${secure}\n"
+        "secure=false\n"
+        "list[]=${secure}\n"
+        "list=string\n"
+        "map[key]=${secure}\n"
+        "map=42\n");
+    EXPECT_EQ(conf["flag"], "v-false");
+    // the recorded references are replaced
+    EXPECT_EQ(conf["list"], "string");
+    EXPECT_EQ(conf["map"], 42);
+}
+
+GTEST_TEST(interpolation, includeAppend) {
+    ::setenv("BLET_TEST_INTERPOLATION", "env", 1);
+    test::blet::FileGuard fragmentGuard("/tmp/blet_test_interpolation_includeAppend_fragment.conf",
+                                        std::ofstream::out | std::ofstream::trunc);
+    fragmentGuard << "list[]=${BLET_TEST_INTERPOLATION}\n"
+                     "list[]=${port}\n"
+                  << std::flush;
+    fragmentGuard.close();
+    test::blet::FileGuard fileGuard("/tmp/blet_test_interpolation_includeAppend.conf",
+                                    std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "port=8080\n"
+                 "list[]=first\n"
+                 "@include blet_test_interpolation_includeAppend_fragment.conf\n"
+              << std::flush;
+    fileGuard.close();
+
+    blet::conf::LoadOptions options;
+    options.interpolation = true;
+    blet::Dict conf = blet::conf::loadFile("/tmp/blet_test_interpolation_includeAppend.conf", options);
+    // the references of fragment are resolved after the elements of file
+    ASSERT_EQ(conf["list"].size(), 3u);
+    EXPECT_EQ(conf["list"][0], "first");
+    EXPECT_EQ(conf["list"][1], "env");
+    EXPECT_EQ(conf["list"][2], 8080);
+}
+
+GTEST_TEST(interpolation, except_not_found) {
+    EXPECT_THROW(
+        {
+            try {
+                s_loadInterpolation("foo=1\n  bar=${BLET_TEST_INTERPOLATION_NOT_FOUND}\n");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_STREQ(e.what(), "Load at 2:3 (Reference ${BLET_TEST_INTERPOLATION_NOT_FOUND} not found)");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+    EXPECT_THROW(s_loadInterpolation("foo=${bar\n"), blet::conf::LoadException);
+    EXPECT_THROW(s_loadInterpolation("foo=${}\n"), blet::conf::LoadException);
+    // not a path and not a environment variable
+    EXPECT_THROW(s_loadInterpolation("foo=${a..b}\n"), blet::conf::LoadException);
+    EXPECT_THROW(s_loadInterpolation("foo=${bar}\n[bar]\nbaz=1\n"), blet::conf::LoadException);
+}
+
+GTEST_TEST(interpolation, except_cycle) {
+    EXPECT_THROW(
+        {
+            try {
+                s_loadInterpolation("a=${b}\nb=${c}\nc=${a}\n");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_EQ(e.message(), "Interpolation cycle");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+}
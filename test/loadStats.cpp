@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include "blet/conf.h"
+#include "mock/fileGuard.h"
+
+GTEST_TEST(loadStats, loadString) {
+    const char confStr[] =
+        "global = 42\n"
+        "[server]\n"
+        "host = \"local\\thost\"\n"
+        "ports = [0x50, 0b1, 017, 8080]\n"
+        "list[] = a\n"
+        "list[] = b\n"
+        "[[nested]]\n"
+        "empty =\n"
+        "flag = true\n";
+    blet::conf::LoadStats stats;
+    blet::conf::LoadOptions options;
+    options.stats = &stats;
+    blet::conf::loadString(confStr, options);
+
+    EXPECT_EQ(stats.bytes, sizeof(confStr) - 1);
+    EXPECT_EQ(stats.files, 1u);
+    EXPECT_GE(stats.readTime, 0.0);
+    EXPECT_GE(stats.parseTime, 0.0);
+    EXPECT_EQ(stats.nodes[blet::Dict::NULL_TYPE], 1u);
+    EXPECT_EQ(stats.nodes[blet::Dict::BOOLEAN_TYPE], 1u);
+    EXPECT_EQ(stats.nodes[blet::Dict::NUMBER_TYPE], 5u);
+    EXPECT_EQ(stats.nodes[blet::Dict::STRING_TYPE], 3u);
+    EXPECT_EQ(stats.nodes[blet::Dict::ARRAY_TYPE], 2u);
+    // root, server, nested
+    EXPECT_EQ(stats.nodes[blet::Dict::OBJECT_TYPE], 3u);
+    EXPECT_EQ(stats.maxDepth, 3u);
+    EXPECT_EQ(stats.sections, 2u);
+    EXPECT_EQ(stats.appends, 2u);
+    EXPECT_EQ(stats.escapedStrings, 1u);
+    EXPECT_EQ(stats.decimalNumbers, 2u);
+    EXPECT_EQ(stats.hexadecimalNumbers, 1u);
+    EXPECT_EQ(stats.binaryNumbers, 1u);
+    EXPECT_EQ(stats.octalNumbers, 1u);
+
+    // cleared by the next load
+    blet::conf::loadString("key=value", options);
+    EXPECT_EQ(stats.bytes, 9u);
+    EXPECT_EQ(stats.sections, 0u);
+    EXPECT_EQ(stats.nodes[blet::Dict::NUMBER_TYPE], 0u);
+    EXPECT_EQ(stats.nodes[blet::Dict::STRING_TYPE], 1u);
+}
+
+GTEST_TEST(loadStats, include) {
+    test::blet::FileGuard fragmentGuard("/tmp/blet_test_loadStats_include_fragment.conf",
+                                        std::ofstream::out | std::ofstream::trunc);
+    fragmentGuard << "port=8080\n" << std::flush;
+    fragmentGuard.close();
+    test::blet::FileGuard fileGuard("/tmp/blet_test_loadStats_include.conf", std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "[server]\n"
+                 "@include \"blet_test_loadStats_include_fragment.conf\"\n"
+              << std::flush;
+    fileGuard.close();
+
+    blet::conf::LoadStats stats;
+    blet::conf::LoadOptions options;
+    options.stats = &stats;
+    blet::conf::loadFile("/tmp/blet_test_loadStats_include.conf", options);
+    EXPECT_EQ(stats.files, 2u);
+    EXPECT_EQ(stats.bytes, 10u + 62u);
+    EXPECT_EQ(stats.sections, 1u);
+    EXPECT_EQ(stats.decimalNumbers, 1u);
+    EXPECT_EQ(stats.nodes[blet::Dict::NUMBER_TYPE], 1u);
+    EXPECT_EQ(stats.maxDepth, 2u);
+}
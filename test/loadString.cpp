@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <sstream>
+
 #include "blet/conf.h"
 
 GTEST_TEST(loadString, comment) {
@@ -343,6 +345,23 @@ GTEST_TEST(loadString, parseValue) {
     EXPECT_EQ(conf["test"]["12"], "default");
 }
 
+GTEST_TEST(loadString, parseValueDecimal) {
+    // clang-format off
+    const char confStr[] = ""
+        "[test]\n"
+        "1 = 1234567\n"
+        "2 = 1234567890123\n"
+        "3 = 3.14159265358979\n"
+        "4 = 0.1\n";
+    // clang-format on
+
+    const blet::Dict conf = blet::conf::loadString(confStr);
+    EXPECT_EQ(conf["test"]["1"], 1234567);
+    EXPECT_EQ(conf["test"]["2"].getValue().getNumber(), 1234567890123.0);
+    EXPECT_EQ(conf["test"]["3"].getValue().getNumber(), 3.14159265358979);
+    EXPECT_EQ(conf["test"]["4"].getValue().getNumber(), 0.1);
+}
+
 GTEST_TEST(loadString, parseValueHex) {
     // clang-format off
     const char confStr[] = ""
@@ -427,3 +446,96 @@ GTEST_TEST(loadString, parseJsonWithSection) {
     const blet::Dict conf = blet::conf::loadString(confStr);
     EXPECT_EQ(conf["test"]["test"], 42);
 }
+
+GTEST_TEST(loadString, arrayGrowth) {
+    std::ostringstream oss;
+    oss << "array=[";
+    for (unsigned int i = 0; i < 100; ++i) {
+        oss << (i > 0 ? "," : "") << "{id=" << i << ",name=\"n" << i << "\"}";
+    }
+    oss << "]\n";
+    for (unsigned int i = 0; i < 100; ++i) {
+        oss << "parents[]={id=" << i << "}\n";
+    }
+
+    const blet::Dict conf = blet::conf::loadString(oss.str());
+    ASSERT_EQ(conf["array"].getValue().getArray().size(), 100u);
+    // the inline arrays are created with one allocation
+    EXPECT_EQ(conf["array"].getValue().getArray().capacity(), 100u);
+    ASSERT_EQ(conf["parents"].getValue().getArray().size(), 100u);
+    for (unsigned int i = 0; i < 100; ++i) {
+        EXPECT_EQ(conf["array"][i]["id"], i);
+        std::ostringstream name;
+        name << "n" << i;
+        EXPECT_EQ(conf["array"][i]["name"], name.str());
+        EXPECT_EQ(conf["parents"][i]["id"], i);
+    }
+}
+
+GTEST_TEST(loadString, sortedKeys) {
+    // clang-format off
+    const char confStr[] = ""
+        "[section]\n"
+        "a = 1\n"
+        "b = 2\n"
+        "d = 4\n"
+        "c = 3\n"
+        "b = 5\n"
+        "e = { x = 1, y = 2, w = 0 }\n"
+        "[other]\n"
+        "[section]\n"
+        "f = 6\n";
+    // clang-format on
+
+    const blet::Dict conf = blet::conf::loadString(confStr);
+    ASSERT_EQ(conf["section"].getValue().getObject().size(), 6u);
+    EXPECT_EQ(conf["section"]["a"], 1);
+    EXPECT_EQ(conf["section"]["b"], 5);
+    EXPECT_EQ(conf["section"]["c"], 3);
+    EXPECT_EQ(conf["section"]["d"], 4);
+    EXPECT_EQ(conf["section"]["e"]["w"], 0);
+    EXPECT_EQ(conf["section"]["e"]["y"], 2);
+    EXPECT_EQ(conf["section"]["f"], 6);
+}
+
+GTEST_TEST(loadString, reopenSections) {
+    // clang-format off
+    const char confStr[] = ""
+        "[foo]\n"
+        "[[bar]]\n"
+        "x = 1\n"
+        "[other]\n"
+        "[foo][bar]\n"
+        "y = 2\n"
+        "[foo]\n"
+        "[[bar]]\n"
+        "z = 3\n"
+        "[]\n"
+        "foo = { w = 4 }\n"
+        "foo =\n"
+        "[foo]\n"
+        "[[bar]]\n"
+        "x = 5\n";
+    // clang-format on
+
+    const blet::Dict conf = blet::conf::loadString(confStr);
+    // the section replaced by a null is a new section
+    EXPECT_FALSE(conf["foo"].contains("w"));
+    EXPECT_EQ(conf["foo"]["bar"]["x"], 5);
+    EXPECT_FALSE(conf["foo"]["bar"].contains("y"));
+    EXPECT_FALSE(conf["foo"]["bar"].contains("z"));
+
+    // more sections than the first size of cache
+    std::ostringstream oss("");
+    for (std::size_t i = 0; i < 40; ++i) {
+        oss << "[section" << i % 20 << "]\n"
+            << "key" << i / 20 << " = " << i << "\n";
+    }
+    const blet::Dict manyConf = blet::conf::loadString(oss.str());
+    for (std::size_t i = 0; i < 20; ++i) {
+        std::ostringstream name("");
+        name << "section" << i;
+        EXPECT_EQ(manyConf[name.str()]["key0"], i);
+        EXPECT_EQ(manyConf[name.str()]["key1"], i + 20);
+    }
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "blet/conf.h"
+#include "mock/fileGuard.h"
+
+GTEST_TEST(memoryResource, newDeleteResource) {
+    blet::conf::MemoryResource& resource = blet::conf::newDeleteResource();
+    EXPECT_EQ(&resource, &blet::conf::newDeleteResource());
+    void* pointer = resource.allocate(42);
+    ASSERT_TRUE(pointer != NULL);
+    resource.deallocate(pointer, 42);
+}
+
+GTEST_TEST(memoryResource, counting) {
+    blet::conf::CountingMemoryResource resource;
+    void* pointer1 = resource.allocate(10);
+    void* pointer2 = resource.allocate(32);
+    EXPECT_EQ(resource.allocated(), 42u);
+    EXPECT_EQ(resource.peak(), 42u);
+    EXPECT_EQ(resource.allocations(), 2u);
+    resource.deallocate(pointer1, 10);
+    EXPECT_EQ(resource.allocated(), 32u);
+    EXPECT_EQ(resource.peak(), 42u);
+    resource.deallocate(pointer2, 32);
+    EXPECT_EQ(resource.allocated(), 0u);
+    EXPECT_EQ(resource.peak(), 42u);
+    EXPECT_EQ(resource.allocations(), 2u);
+}
+
+GTEST_TEST(memoryResource, loadString) {
+    const char confStr[] = "[server]\nhost=localhost\nport=8080\n";
+    blet::conf::CountingMemoryResource resource;
+    blet::conf::LoadOptions options;
+    options.memoryResource = &resource;
+    blet::Dict conf = blet::conf::loadString(confStr, options);
+    EXPECT_EQ(conf["server"]["host"], "localhost");
+    EXPECT_EQ(conf["server"]["port"], 8080);
+    // the buffer of content with its end character
+    EXPECT_EQ(resource.allocations(), 1u);
+    EXPECT_EQ(resource.peak(), sizeof(confStr));
+    EXPECT_EQ(resource.allocated(), 0u);
+}
+
+GTEST_TEST(memoryResource, readBufferOnly) {
+    const char* testFile = "/tmp/blet_test_memoryResource_readBufferOnly.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    std::ostringstream oss("");
+    for (std::size_t i = 0; i < 100; ++i) {
+        oss << "[section" << i << "]\n"
+            << "key=" << std::string(100, 'x') << "\n";
+    }
+    const std::string content = oss.str();
+    fileGuard << content << std::flush;
+    fileGuard.close();
+
+    blet::conf::CountingMemoryResource resource;
+    blet::conf::LoadOptions options;
+    options.memoryResource = &resource;
+    blet::Dict conf = blet::conf::loadFile(testFile, options);
+    EXPECT_EQ(conf["section99"]["key"], std::string(100, 'x'));
+    // the resource only saw the buffer of content, not the loaded tree
+    EXPECT_EQ(resource.allocations(), 1u);
+    EXPECT_EQ(resource.peak(), content.size() + 1);
+    EXPECT_EQ(resource.allocated(), 0u);
+}
+
+GTEST_TEST(memoryResource, include) {
+    test::blet::FileGuard fragmentGuard("/tmp/blet_test_memoryResource_include_fragment.conf",
+                                        std::ofstream::out | std::ofstream::trunc);
+    fragmentGuard << "port=8080\n" << std::flush;
+    fragmentGuard.close();
+    test::blet::FileGuard fileGuard("/tmp/blet_test_memoryResource_include.conf",
+                                    std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "[server]\n"
+                 "@include \"blet_test_memoryResource_include_fragment.conf\"\n"
+              << std::flush;
+    fileGuard.close();
+
+    blet::conf::CountingMemoryResource resource;
+    blet::conf::LoadOptions options;
+    options.memoryResource = &resource;
+    blet::Dict conf = blet::conf::loadFile("/tmp/blet_test_memoryResource_include.conf", options);
+    EXPECT_EQ(conf["server"]["port"], 8080);
+    EXPECT_EQ(resource.allocations(), 2u);
+    EXPECT_EQ(resource.allocated(), 0u);
+}
+
+GTEST_TEST(memoryResource, throwAllocate) {
+    class ThrowResource : public blet::conf::MemoryResource {
+      public:
+        void* allocate(std::size_t /*size*/) {
+            throw std::bad_alloc();
+        }
+        void deallocate(void* /*pointer*/, std::size_t /*size*/) {}
+    };
+    ThrowResource resource;
+    blet::conf::LoadOptions options;
+    options.memoryResource = &resource;
+    EXPECT_THROW(blet::conf::loadString("key=value", options), std::bad_alloc);
+}
+
+GTEST_TEST(memoryResource, notSeekableStream) {
+    // stream buffer without seek
+    class PipeBuf : public std::streambuf {
+      public:
+        PipeBuf(const std::string& str) :
+            str_(str),
+            pos_(0) {}
+
+      protected:
+        int_type underflow() {
+            if (pos_ == str_.size()) {
+                return traits_type::eof();
+            }
+            // give one character by call like a pipe
+            c_ = str_[pos_++];
+            setg(&c_, &c_, &c_ + 1);
+            return traits_type::to_int_type(c_);
+        }
+
+      private:
+        std::string str_;
+        std::size_t pos_;
+        char c_;
+    };
+    std::string confStr("[server]\nhost=localhost\n");
+    for (std::size_t i = 0; i < 500; ++i) {
+        confStr += "port=8080\n";
+    }
+    PipeBuf pipeBuf(confStr);
+    std::istream stream(&pipeBuf);
+    blet::conf::CountingMemoryResource resource;
+    blet::conf::LoadOptions options;
+    options.memoryResource = &resource;
+    blet::Dict conf = blet::conf::loadStream(stream, options);
+    EXPECT_EQ(conf["server"]["host"], "localhost");
+    EXPECT_EQ(conf["server"]["port"], 8080);
+    // buffer of 4096 then 8192 bytes
+    EXPECT_EQ(resource.allocations(), 2u);
+    EXPECT_EQ(resource.allocated(), 0u);
+
+    PipeBuf emptyBuf("");
+    std::istream emptyStream(&emptyBuf);
+    EXPECT_TRUE(blet::conf::loadStream(emptyStream).isNull());
+}
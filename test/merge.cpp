@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include "blet/conf.h"
+
+GTEST_TEST(merge, override_policy) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "host=localhost\n"
+        "port=80\n"
+        "aliases=[foo]\n"
+        "[log]\n"
+        "level=info\n");
+    blet::Dict layer = blet::conf::loadString(
+        "[server]\n"
+        "port=8080\n"
+        "aliases=[bar]\n"
+        "[cache]\n"
+        "size=42\n");
+    const blet::Dict* log = &conf["log"];
+    blet::conf::merge(conf, layer);
+    EXPECT_EQ(conf["server"]["host"], "localhost");
+    EXPECT_EQ(conf["server"]["port"], 8080);
+    ASSERT_EQ(conf["server"]["aliases"].size(), 1u);
+    EXPECT_EQ(conf["server"]["aliases"][0], "bar");
+    EXPECT_EQ(conf["cache"]["size"], 42);
+    // the unchanged values are not copied
+    EXPECT_EQ(&conf["log"], log);
+    EXPECT_EQ(conf["log"]["level"], "info");
+}
+
+GTEST_TEST(merge, append_policy) {
+    blet::Dict conf = blet::conf::loadString("aliases=[foo]\nport=80\n");
+    blet::Dict layer = blet::conf::loadString("aliases=[bar, baz]\nport=8080\n");
+    blet::conf::merge(conf, layer, blet::conf::APPEND_POLICY);
+    ASSERT_EQ(conf["aliases"].size(), 3u);
+    EXPECT_EQ(conf["aliases"][0], "foo");
+    EXPECT_EQ(conf["aliases"][1], "bar");
+    EXPECT_EQ(conf["aliases"][2], "baz");
+    EXPECT_EQ(conf["port"], 8080);
+}
+
+GTEST_TEST(merge, error_policy) {
+    blet::Dict conf = blet::conf::loadString("[server]\nhost=localhost\nport=80\n");
+    blet::Dict layer = blet::conf::loadString("[server]\nhost=localhost\nname=foo\n");
+    blet::conf::merge(conf, layer, blet::conf::ERROR_POLICY);
+    EXPECT_EQ(conf["server"]["name"], "foo");
+
+    blet::Dict conflict = blet::conf::loadString("[server]\nname=bar\nport=8080\n");
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::merge(conf, conflict, blet::conf::ERROR_POLICY);
+            }
+            catch (const blet::conf::MergeException& e) {
+                EXPECT_STREQ(e.what(), "Merge server.name: (Conflict)");
+                EXPECT_EQ(e.path(), "server.name");
+                EXPECT_EQ(e.message(), "Conflict");
+                throw;
+            }
+        },
+        blet::conf::MergeException);
+    // not modified
+    EXPECT_EQ(conf["server"]["name"], "foo");
+    EXPECT_EQ(conf["server"]["port"], 80);
+}
+
+GTEST_TEST(merge, error_policy_equal) {
+    blet::Dict conf = blet::conf::loadString(
+        "null=\n"
+        "boolean=true\n"
+        "number=42\n"
+        "string=foo\n"
+        "array=[1, [2, 3], {a=1, b=[]}]\n"
+        "[object]\n"
+        "key=value\n");
+    // the identical values are not conflicts
+    blet::Dict layer(conf);
+    blet::conf::merge(conf, layer, blet::conf::ERROR_POLICY);
+    EXPECT_TRUE(conf["null"].isNull());
+    EXPECT_EQ(conf["boolean"], true);
+    EXPECT_EQ(conf["number"], 42);
+    EXPECT_EQ(conf["string"], "foo");
+    ASSERT_EQ(conf["array"].size(), 3u);
+    EXPECT_EQ(conf["array"][2]["a"], 1);
+    EXPECT_EQ(conf["object"]["key"], "value");
+}
+
+GTEST_TEST(merge, error_policy_conflict) {
+    const char* confStr =
+        "boolean=true\n"
+        "number=42\n"
+        "array=[1, [2, 3], {a=1, b=[]}]\n"
+        "\"a.b\"=[]\n"
+        "[object]\n"
+        "key=value\n";
+    const char* layers[][2] = {
+        {"boolean=false\n", "boolean"},
+        {"number=43\n", "number"},
+        // type mismatch
+        {"number=\"42\"\n", "number"},
+        {"object=value\n", "object"},
+        {"array=[1, [2, 3]]\n", "array"},
+        {"array=[1, [2, 4], {a=1, b=[]}]\n", "array"},
+        {"array=[1, [2, 3], {a=1}]\n", "array"},
+        {"array=[1, [2, 3], {a=1, c=[]}]\n", "array"},
+        {"array=[1, [2, 3], {a=2, b=[]}]\n", "array"},
+        {"\"a.b\"=[1]\n", "\"a.b\""},
+        {"[object]\nkey=\n", "object.key"},
+    };
+    for (std::size_t i = 0; i < sizeof(layers) / sizeof(*layers); ++i) {
+        blet::Dict conf = blet::conf::loadString(confStr);
+        blet::Dict layer = blet::conf::loadString(layers[i][0]);
+        EXPECT_THROW(
+            {
+                try {
+                    blet::conf::merge(conf, layer, blet::conf::ERROR_POLICY);
+                }
+                catch (const blet::conf::MergeException& e) {
+                    EXPECT_EQ(e.path(), layers[i][1]);
+                    throw;
+                }
+            },
+            blet::conf::MergeException)
+            << layers[i][0];
+    }
+}
+
+GTEST_TEST(merge, error_policy_quoted_path) {
+    blet::Dict conf = blet::conf::loadString("[\"a.b\"]\n\"c\\\"d\"=1\n[e]\n\"\"=1\n");
+    blet::Dict layer = blet::conf::loadString("[\"a.b\"]\n\"c\\\"d\"=2\n");
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::merge(conf, layer, blet::conf::ERROR_POLICY);
+            }
+            catch (const blet::conf::MergeException& e) {
+                EXPECT_EQ(e.path(), "\"a.b\".\"c\\\"d\"");
+                // the path is valid for the accessor
+                EXPECT_EQ(*blet::conf::Accessor(e.path().c_str()).find(conf), 1);
+                throw;
+            }
+        },
+        blet::conf::MergeException);
+    blet::Dict emptyLayer = blet::conf::loadString("[e]\n\"\"=2\n");
+    EXPECT_THROW(
+        {
+            try {
+                blet::conf::merge(conf, emptyLayer, blet::conf::ERROR_POLICY);
+            }
+            catch (const blet::conf::MergeException& e) {
+                EXPECT_EQ(e.path(), "e.\"\"");
+                throw;
+            }
+        },
+        blet::conf::MergeException);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <pthread.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "blet/conf.h"
+
+// replace the global operator new for check the allocations of lookups
+static std::size_t s_allocations = 0;
+
+void* operator new(std::size_t size) {
+    __atomic_add_fetch(&s_allocations, 1, __ATOMIC_RELAXED);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+static std::size_t s_deallocations = 0;
+
+void operator delete(void* ptr) throw() {
+    if (ptr != NULL) {
+        __atomic_add_fetch(&s_deallocations, 1, __ATOMIC_RELAXED);
+    }
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) throw() {
+    if (ptr != NULL) {
+        __atomic_add_fetch(&s_deallocations, 1, __ATOMIC_RELAXED);
+    }
+    std::free(ptr);
+}
+
+static std::size_t s_getAllocations() {
+    return __atomic_load_n(&s_allocations, __ATOMIC_RELAXED);
+}
+
+static std::size_t s_getDeallocations() {
+    return __atomic_load_n(&s_deallocations, __ATOMIC_RELAXED);
+}
+
+GTEST_TEST(path, find) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "host=localhost\n"
+        "ports=[80, 443]\n"
+        "[[client]]\n"
+        "name=foo\n");
+    blet::conf::Path path;
+    path["server"]["ports"][1];
+    EXPECT_EQ(path.size(), 3u);
+    ASSERT_TRUE(path.find(conf) != NULL);
+    EXPECT_EQ(*path.find(conf), 443);
+    EXPECT_EQ(blet::conf::Path()["server"][std::string("host")].at(conf), "localhost");
+    EXPECT_EQ(blet::conf::Path()["server"].key("client", 6)["name"].at(conf), "foo");
+    EXPECT_EQ(&blet::conf::Path().at(conf), &conf);
+}
+
+GTEST_TEST(path, notFound) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "host=localhost\n"
+        "ports=[80, 443]\n");
+    EXPECT_FALSE(blet::conf::Path()["client"].contains(conf));
+    EXPECT_FALSE(blet::conf::Path()["server"]["ports"][2].contains(conf));
+    EXPECT_FALSE(blet::conf::Path()["server"][0].contains(conf));
+    EXPECT_FALSE(blet::conf::Path()["server"]["ports"]["host"].contains(conf));
+    EXPECT_FALSE(blet::conf::Path()["server"]["host"]["host"].contains(conf));
+    EXPECT_TRUE(blet::conf::Path()["server"]["ports"][0].contains(conf));
+    EXPECT_THROW(blet::conf::Path()["server"]["port"].at(conf), std::out_of_range);
+}
+
+GTEST_TEST(path, tooManySegments) {
+    blet::conf::Path path;
+    for (std::size_t i = 0; i < blet::conf::Path::MAX_SEGMENTS; ++i) {
+        path[i];
+    }
+    EXPECT_EQ(path.size(), static_cast<std::size_t>(blet::conf::Path::MAX_SEGMENTS));
+    EXPECT_THROW(path["key"], std::length_error);
+    EXPECT_THROW(path[0], std::length_error);
+    EXPECT_EQ(path.size(), static_cast<std::size_t>(blet::conf::Path::MAX_SEGMENTS));
+}
+
+GTEST_TEST(path, noAllocation) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "host=localhost\n"
+        "ports=[80, 443]\n"
+        "[[client]]\n"
+        "name=foo\n");
+    blet::conf::Path path;
+    path["server"]["client"]["name"];
+    // first lookup reserve the key buffer of thread
+    ASSERT_TRUE(path.contains(conf));
+    std::size_t allocations = s_getAllocations();
+    for (std::size_t i = 0; i < 100; ++i) {
+        blet::conf::Path ports;
+        ports["server"]["ports"][i % 2];
+        EXPECT_TRUE(ports.contains(conf));
+        EXPECT_TRUE(path.contains(conf));
+    }
+    EXPECT_EQ(s_getAllocations(), allocations);
+}
+
+GTEST_TEST(path, findKey) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "host=localhost\n"
+        "ports=[80, 443]\n");
+    const blet::Dict& constConf = conf;
+    ASSERT_TRUE(blet::conf::find(constConf, "server") != NULL);
+    EXPECT_EQ(*blet::conf::find(constConf["server"], "hostname", 4), "localhost");
+    EXPECT_TRUE(blet::conf::find(conf, "client") == NULL);
+    EXPECT_TRUE(blet::conf::find(conf["server"]["ports"], "host") == NULL);
+    blet::conf::at(conf, "server")["host"] = "127.0.0.1";
+    EXPECT_EQ(blet::conf::at(constConf["server"], "host"), "127.0.0.1");
+    EXPECT_THROW(blet::conf::at(constConf, "client"), std::out_of_range);
+    EXPECT_TRUE(blet::conf::contains(conf, "server"));
+    EXPECT_FALSE(blet::conf::contains(conf["server"]["host"], "server"));
+#if __cplusplus >= 201703L
+    EXPECT_TRUE(blet::conf::contains(conf, std::string_view("server")));
+    EXPECT_EQ(blet::conf::at(constConf, std::string_view("server.host", 6))["host"], "127.0.0.1");
+#endif
+}
+
+GTEST_TEST(path, findKeyNoAllocation) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "a_long_key_without_small_string_optimization=42\n");
+    const blet::Dict& server = conf["server"];
+    // first lookup reserve the key buffer of thread
+    ASSERT_FALSE(blet::conf::contains(server, "a_long_key_not_found_without_small_string_optimization"));
+    std::size_t allocations = s_getAllocations();
+    for (std::size_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(blet::conf::at(server, "a_long_key_without_small_string_optimization"), 42);
+        EXPECT_FALSE(blet::conf::contains(server, "a_long_key_not_found_without_small_string_optimization"));
+    }
+    EXPECT_EQ(s_getAllocations(), allocations);
+}
+
+struct LookupData {
+    const blet::Dict* server;
+    bool found;
+};
+
+static void* s_lookupThread(void* data) {
+    LookupData* lookupData = static_cast<LookupData*>(data);
+    const char* key = "a_long_key_without_small_string_optimization";
+    std::size_t size = ::strlen(key);
+    lookupData->found = blet::conf::find(*lookupData->server, key, size) != NULL &&
+                        blet::conf::at(*lookupData->server, key, size) == 42;
+    return NULL;
+}
+
+GTEST_TEST(path, findKeyThreadExit) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "a_long_key_without_small_string_optimization=42\n");
+    LookupData lookupData;
+    lookupData.server = &conf["server"];
+    lookupData.found = false;
+    std::size_t allocations = s_getAllocations();
+    std::size_t deallocations = s_getDeallocations();
+    pthread_t thread;
+    ASSERT_EQ(::pthread_create(&thread, NULL, &s_lookupThread, &lookupData), 0);
+    ::pthread_join(thread, NULL);
+    EXPECT_TRUE(lookupData.found);
+    // the key buffer of the thread is deleted at its exit
+    EXPECT_GT(s_getAllocations(), allocations);
+    EXPECT_EQ(s_getAllocations() - allocations, s_getDeallocations() - deallocations);
+}
+
+struct SharedPathData {
+    const blet::conf::Path* path;
+    const blet::Dict* conf;
+    bool error;
+};
+
+static void* s_sharedPathThread(void* data) {
+    SharedPathData* sharedPathData = static_cast<SharedPathData*>(data);
+    for (std::size_t i = 0; i < 10000; ++i) {
+        const blet::Dict* node = sharedPathData->path->find(*sharedPathData->conf);
+        if (node == NULL || *node != 42) {
+            sharedPathData->error = true;
+        }
+    }
+    return NULL;
+}
+
+GTEST_TEST(path, sharedConstPath) {
+    const blet::Dict conf = blet::conf::loadString(
+        "[a_long_section_without_small_string_optimization]\n"
+        "a_long_key_without_small_string_optimization=[42]\n");
+    blet::conf::Path path;
+    path["a_long_section_without_small_string_optimization"]["a_long_key_without_small_string_optimization"][0];
+    const blet::conf::Path& sharedPath = path;
+
+    // a const path is read only, the threads use their own key buffer
+    SharedPathData sharedPathData[2];
+    pthread_t threads[2];
+    for (std::size_t i = 0; i < 2; ++i) {
+        sharedPathData[i].path = &sharedPath;
+        sharedPathData[i].conf = &conf;
+        sharedPathData[i].error = false;
+        ASSERT_EQ(::pthread_create(&threads[i], NULL, &s_sharedPathThread, &sharedPathData[i]), 0);
+    }
+    for (std::size_t i = 0; i < 2; ++i) {
+        ::pthread_join(threads[i], NULL);
+        EXPECT_FALSE(sharedPathData[i].error);
+    }
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "blet/conf.h"
+#include "mock/fileGuard.h"
+
+GTEST_TEST(reload, no_change) {
+    blet::Dict conf = blet::conf::loadString("[section]\nfoo=42\nbar[]=1\nbar[]=2\n[[sub]]\nstr=\"toto\"");
+    blet::Dict newConf = blet::conf::loadString("[section]\nfoo=42\nbar[]=1\nbar[]=2\n[[sub]]\nstr=\"toto\"");
+    const blet::Dict* pSub = &conf["section"]["sub"];
+    blet::conf::Changes changes = blet::conf::reload(conf, newConf);
+    EXPECT_TRUE(changes.empty());
+    EXPECT_EQ(pSub, &conf["section"]["sub"]);
+}
+
+GTEST_TEST(reload, changes) {
+    blet::Dict conf = blet::conf::loadString(""
+                                             "[section]\n"
+                                             "foo=42\n"
+                                             "removed=true\n"
+                                             "arr[]=1\n"
+                                             "arr[]=2\n"
+                                             "arr2[]=1\n"
+                                             "arr2[]=2\n"
+                                             "[[sub]]\n"
+                                             "str=\"toto\"\n"
+                                             "type=42\n"
+                                             "[unchanged]\n"
+                                             "foo=bar");
+    blet::Dict newConf = blet::conf::loadString(""
+                                                "[section]\n"
+                                                "foo=24\n"
+                                                "added=false\n"
+                                                "arr[]=1\n"
+                                                "arr[]=2\n"
+                                                "arr[]=3\n"
+                                                "arr2[]=1\n"
+                                                "[[sub]]\n"
+                                                "str=\"toto\"\n"
+                                                "type=\"42\"\n"
+                                                "[unchanged]\n"
+                                                "foo=bar");
+    const blet::Dict* pUnchanged = &conf["unchanged"];
+    const blet::Dict* pStr = &conf["section"]["sub"]["str"];
+    blet::conf::Changes changes = blet::conf::reload(conf, newConf);
+
+    EXPECT_EQ(conf, blet::conf::loadString(blet::conf::dump(conf)));
+    EXPECT_EQ(blet::conf::dump(conf), "[section]\n"
+                                      "added=false\n"
+                                      "arr[]=1\n"
+                                      "arr[]=2\n"
+                                      "arr[]=3\n"
+                                      "arr2[]=1\n"
+                                      "foo=24\n"
+                                      "[[sub]]\n"
+                                      "str=\"toto\"\n"
+                                      "type=\"42\"\n"
+                                      "[unchanged]\n"
+                                      "foo=\"bar\"");
+    EXPECT_EQ(pUnchanged, &conf["unchanged"]);
+    EXPECT_EQ(pStr, &conf["section"]["sub"]["str"]);
+
+    ASSERT_EQ(changes.added.size(), 2);
+    EXPECT_EQ(changes.added[0], blet::Dict::Path()["section"]["added"]);
+    EXPECT_EQ(changes.added[1], blet::Dict::Path()["section"]["arr"][2]);
+    ASSERT_EQ(changes.removed.size(), 2);
+    EXPECT_EQ(changes.removed[0], blet::Dict::Path()["section"]["arr2"][1]);
+    EXPECT_EQ(changes.removed[1], blet::Dict::Path()["section"]["removed"]);
+    ASSERT_EQ(changes.modified.size(), 2);
+    EXPECT_EQ(changes.modified[0], blet::Dict::Path()["section"]["foo"]);
+    EXPECT_EQ(changes.modified[1], blet::Dict::Path()["section"]["sub"]["type"]);
+}
+
+GTEST_TEST(reload, types) {
+    blet::Dict conf = blet::conf::loadString(""
+                                             "flip=true\n"
+                                             "keep=false\n"
+                                             "null=\n"
+                                             "toNull=42\n"
+                                             "fromNull=\n"
+                                             "str=foo\n"
+                                             "arr=[1, true, foo]\n"
+                                             "[object]\n"
+                                             "key=value\n");
+    blet::Dict newConf = blet::conf::loadString(""
+                                                "flip=false\n"
+                                                "keep=false\n"
+                                                "null=\n"
+                                                "toNull=\n"
+                                                "fromNull=true\n"
+                                                "str=bar\n"
+                                                "arr=[1, false, [foo]]\n"
+                                                "object=[key, value]\n");
+    blet::conf::Changes changes = blet::conf::reload(conf, newConf);
+    EXPECT_EQ(conf["flip"], false);
+    EXPECT_EQ(conf["keep"], false);
+    EXPECT_TRUE(conf["null"].isNull());
+    EXPECT_TRUE(conf["toNull"].isNull());
+    EXPECT_EQ(conf["fromNull"], true);
+    EXPECT_EQ(conf["str"], "bar");
+    EXPECT_EQ(conf["arr"][2][0], "foo");
+    EXPECT_EQ(conf["object"][1], "value");
+
+    EXPECT_TRUE(changes.added.empty());
+    EXPECT_TRUE(changes.removed.empty());
+    ASSERT_EQ(changes.modified.size(), 7);
+    EXPECT_EQ(changes.modified[0], blet::Dict::Path()["arr"][1]);
+    EXPECT_EQ(changes.modified[1], blet::Dict::Path()["arr"][2]);
+    EXPECT_EQ(changes.modified[2], blet::Dict::Path()["flip"]);
+    EXPECT_EQ(changes.modified[3], blet::Dict::Path()["fromNull"]);
+    EXPECT_EQ(changes.modified[4], blet::Dict::Path()["object"]);
+    EXPECT_EQ(changes.modified[5], blet::Dict::Path()["str"]);
+    EXPECT_EQ(changes.modified[6], blet::Dict::Path()["toNull"]);
+}
+
+GTEST_TEST(reloadFile, except_parsing) {
+    const char* testFile = "/tmp/blet_test_reloadFile_except_parsing.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "[section]\n=" << std::flush;
+    fileGuard.close();
+
+    blet::Dict conf = blet::conf::loadString("[section]\nfoo=42");
+    EXPECT_THROW(blet::conf::reloadFile(conf, testFile), blet::conf::LoadException);
+    EXPECT_EQ(conf["section"]["foo"], 42);
+}
+
+GTEST_TEST(reloadFile, valid) {
+    const char* testFile = "/tmp/blet_test_reloadFile_valid.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "[section]\nfoo=24" << std::flush;
+    fileGuard.close();
+
+    blet::Dict conf = blet::conf::loadString("[section]\nfoo=42");
+    blet::conf::Changes changes = blet::conf::reloadFile(conf, testFile);
+    EXPECT_EQ(conf["section"]["foo"], 24);
+    ASSERT_EQ(changes.modified.size(), 1);
+    EXPECT_EQ(changes.modified[0], blet::Dict::Path()["section"]["foo"]);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "blet/conf.h"
+
+GTEST_TEST(schema, except_pattern) {
+    blet::conf::Schema schema;
+    EXPECT_THROW(schema.pattern("[a-z"), std::invalid_argument);
+}
+
+GTEST_TEST(schema, valid) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "host=localhost\n"
+        "port=8080\n"
+        "[tenants]\n"
+        "[[foo]]\n"
+        "name=foo\n"
+        "ids=[1, 2]\n"
+        "[[bar]]\n"
+        "name=bar\n"
+        "ids=[3]\n");
+
+    blet::conf::Schema schema;
+    schema.key("server").required().type(blet::Dict::OBJECT_TYPE);
+    schema.key("server").key("host").required().type(blet::Dict::STRING_TYPE);
+    schema.key("server").key("port").required().type(blet::Dict::NUMBER_TYPE).range(1, 65535);
+    schema.key("tenants").key("*").key("name").required().pattern("^[a-z]+$");
+    schema.key("tenants").key("*").key("ids").size(1, 4).items().type(blet::Dict::NUMBER_TYPE);
+    schema.key("optional").type(blet::Dict::BOOLEAN_TYPE);
+    EXPECT_TRUE(schema.validate(conf).empty());
+}
+
+GTEST_TEST(schema, violations) {
+    blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "port=80000\n"
+        "[tenants]\n"
+        "[[foo]]\n"
+        "name=Foo\n"
+        "ids=[]\n"
+        "[[\"bar.baz\"]]\n"
+        "ids=[3, \"4\"]\n"
+        "[other]\n");
+
+    blet::conf::Schema schema;
+    schema.key("server").key("host").required().type(blet::Dict::STRING_TYPE);
+    schema.key("server").key("port").required().type(blet::Dict::NUMBER_TYPE).range(1, 65535);
+    schema.key("tenants").key("*").key("name").required().pattern("^[a-z]+$");
+    schema.key("tenants").key("*").key("ids").size(1, 4).items().type(blet::Dict::NUMBER_TYPE);
+    schema.key("other").type(blet::Dict::STRING_TYPE);
+
+    std::vector<blet::conf::LoadException> violations = schema.validate(conf);
+    ASSERT_EQ(violations.size(), 7u);
+    EXPECT_EQ(violations[0].message(), "other: is not a string (is null)");
+    EXPECT_EQ(violations[1].message(), "server.host: is not found");
+    EXPECT_EQ(violations[2].message(), "server.port: is out of range [1, 65535]");
+    EXPECT_EQ(violations[3].message(), "tenants.\"bar.baz\".ids[1]: is not a number (is string)");
+    EXPECT_EQ(violations[4].message(), "tenants.\"bar.baz\".name: is not found");
+    EXPECT_EQ(violations[5].message(), "tenants.foo.ids: size 0 is out of range [1, 4]");
+    EXPECT_EQ(violations[6].message(), "tenants.foo.name: does not match \"^[a-z]+$\"");
+}
+
+GTEST_TEST(schema, violations_not_object) {
+    blet::Dict conf = blet::conf::loadString(
+        "server=42\n"
+        "[\"quo\\\"te\\\\\"]\n"
+        "[\"back\\\\slash\"]\n");
+
+    blet::conf::Schema schema;
+    // a not object value has not the required keys
+    schema.key("server").key("host").required();
+    schema.key("server").key("port").required().required(false);
+    schema.key("server").key("name");
+    schema.key("quo\"te\\").key("key").required();
+    schema.key("back\\slash").key("key").required();
+    // the last pattern replaces the previous
+    schema.key("name").pattern("^[0-9]+$").pattern("^[a-z]+$");
+
+    blet::Dict name = "foo";
+    EXPECT_TRUE(schema.key("name").validate(name).empty());
+
+    std::vector<blet::conf::LoadException> violations = schema.validate(conf);
+    ASSERT_EQ(violations.size(), 3u);
+    EXPECT_EQ(violations[0].message(), "back\\slash.key: is not found");
+    EXPECT_EQ(violations[1].message(), "\"quo\\\"te\\\\\".key: is not found");
+    EXPECT_EQ(violations[2].message(), "server.host: is not found");
+}
@@ -0,0 +1,187 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include "blet/conf.h"
+
+GTEST_TEST(sharedDocument, createOpen) {
+    const blet::Dict conf = blet::conf::loadString(
+        "[server]\n"
+        "host=localhost\n"
+        "port=8080\n"
+        "secure=true\n"
+        "empty=\n"
+        "aliases=[foo, bar, {\"a.b\"=42}]\n"
+        "[other]\n"
+        "key=value\n");
+    blet::conf::SharedDocument::create("/blet_test_sharedDocument_createOpen", conf);
+
+    blet::conf::SharedDocument document;
+    EXPECT_FALSE(document.isOpen());
+    document.open("/blet_test_sharedDocument_createOpen");
+    blet::conf::SharedDocument::unlink("/blet_test_sharedDocument_createOpen");
+    ASSERT_TRUE(document.isOpen());
+    EXPECT_GT(document.size(), 0u);
+
+    blet::conf::SharedDocument::Value root = document.root();
+    ASSERT_TRUE(root.isObject());
+    ASSERT_EQ(root.size(), 2u);
+    EXPECT_EQ(root.key(0), "other");
+    EXPECT_EQ(root.key(1), "server");
+    EXPECT_TRUE(root.contains("server"));
+    EXPECT_FALSE(root.contains("serve"));
+    EXPECT_FALSE(root.contains("serverr"));
+    EXPECT_EQ(root["server"]["host"].getString(), "localhost");
+    EXPECT_STREQ(root["server"]["host"].c_str(), "localhost");
+    EXPECT_EQ(root["server"]["port"].getNumber(), 8080);
+    EXPECT_EQ(root["server"]["secure"].getBoolean(), true);
+    EXPECT_TRUE(root["server"]["empty"].isNull());
+    EXPECT_EQ(root["server"]["aliases"].size(), 3u);
+    EXPECT_EQ(root["server"]["aliases"][1].getString(), "bar");
+    EXPECT_EQ(root["other"].value(0).getString(), "value");
+    EXPECT_THROW(root["server"]["port"].getString(), std::invalid_argument);
+    EXPECT_THROW(root["server"]["aliases"][3], std::out_of_range);
+    EXPECT_THROW(root["notfound"], std::out_of_range);
+
+    blet::conf::SharedDocument::Value value;
+    ASSERT_TRUE(document.find(blet::conf::Accessor("server.aliases[2].\"a.b\""), value));
+    EXPECT_EQ(value.getNumber(), 42);
+    EXPECT_FALSE(document.find(blet::conf::Accessor("server.aliases[3]"), value));
+    EXPECT_FALSE(document.find(blet::conf::Accessor("server.host.foo"), value));
+
+    EXPECT_EQ(blet::conf::dump(root.toDict()), blet::conf::dump(conf));
+
+    document.close();
+    EXPECT_FALSE(document.isOpen());
+    EXPECT_TRUE(document.root().isNull());
+}
+
+GTEST_TEST(sharedDocument, otherProcess) {
+    const blet::Dict conf = blet::conf::loadString("[server]\nport=8080\n");
+    blet::conf::SharedDocument::create("/blet_test_sharedDocument_otherProcess", conf);
+
+    pid_t pid = ::fork();
+    ASSERT_NE(pid, -1);
+    if (pid == 0) {
+        blet::conf::SharedDocument document;
+        document.open("/blet_test_sharedDocument_otherProcess");
+        ::_exit(document.root()["server"]["port"].getNumber() == 8080 ? 0 : 1);
+    }
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    blet::conf::SharedDocument::unlink("/blet_test_sharedDocument_otherProcess");
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+GTEST_TEST(sharedDocument, replace) {
+    blet::conf::SharedDocument::create("/blet_test_sharedDocument_replace", blet::conf::loadString("version=1"));
+    blet::conf::SharedDocument document;
+    document.open("/blet_test_sharedDocument_replace");
+    blet::conf::SharedDocument::create("/blet_test_sharedDocument_replace", blet::conf::loadString("version=2"));
+    // the opened document is not changed
+    EXPECT_EQ(document.root()["version"].getNumber(), 1);
+    document.open("/blet_test_sharedDocument_replace");
+    EXPECT_EQ(document.root()["version"].getNumber(), 2);
+    blet::conf::SharedDocument::unlink("/blet_test_sharedDocument_replace");
+}
+
+GTEST_TEST(sharedDocument, except) {
+    blet::conf::SharedDocument document;
+    EXPECT_THROW(document.open("/blet_test_sharedDocument_notfound"), blet::conf::LoadException);
+    EXPECT_THROW(blet::conf::SharedDocument::create("/bad/name", blet::Dict()), blet::conf::LoadException);
+}
+
+GTEST_TEST(sharedDocument, except_value) {
+    blet::conf::SharedDocument::create("/blet_test_sharedDocument_except_value",
+                                       blet::conf::loadString("boolean=true\nnumber=42\nempty=\n"));
+    blet::conf::SharedDocument document;
+    blet::conf::SharedDocument::Value value;
+    // not opened
+    EXPECT_FALSE(document.find(blet::conf::Accessor("number"), value));
+    document.open("/blet_test_sharedDocument_except_value");
+    blet::conf::SharedDocument::unlink("/blet_test_sharedDocument_except_value");
+    blet::conf::SharedDocument::Value root = document.root();
+    EXPECT_THROW(root["number"].getBoolean(), std::invalid_argument);
+    EXPECT_THROW(root["boolean"].getNumber(), std::invalid_argument);
+    EXPECT_EQ(root["boolean"].size(), 0u);
+    EXPECT_EQ(root["number"].size(), 0u);
+    EXPECT_EQ(root["empty"].size(), 0u);
+    EXPECT_THROW(root.key(3), std::out_of_range);
+    EXPECT_THROW(root.value(3), std::out_of_range);
+    EXPECT_THROW(root["number"].key(0), std::out_of_range);
+    EXPECT_THROW(root["number"].value(0), std::out_of_range);
+}
+
+static void s_createForeign(const char* name, const std::string& content) {
+    int fd = ::shm_open(name, O_CREAT | O_TRUNC | O_RDWR, 0644);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(::write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+    ::close(fd);
+}
+
+GTEST_TEST(sharedDocument, except_foreign) {
+    blet::conf::SharedDocument document;
+    // smaller than a document
+    s_createForeign("/blet_test_sharedDocument_except_foreign", "foo");
+    EXPECT_THROW(document.open("/blet_test_sharedDocument_except_foreign"), blet::conf::LoadException);
+    // without the magic of document
+    s_createForeign("/blet_test_sharedDocument_except_foreign", std::string(4096, 'x'));
+    EXPECT_THROW(
+        {
+            try {
+                document.open("/blet_test_sharedDocument_except_foreign");
+            }
+            catch (const blet::conf::LoadException& e) {
+                EXPECT_EQ(e.message(), "Invalid shared document");
+                throw;
+            }
+        },
+        blet::conf::LoadException);
+    blet::conf::SharedDocument::unlink("/blet_test_sharedDocument_except_foreign");
+    EXPECT_FALSE(document.isOpen());
+}
+
+GTEST_TEST(sharedDocument, except_limits) {
+    blet::Dict conf;
+    conf["large"] = std::string(16 * 1024 * 1024, 'x');
+    struct rlimit limit;
+
+    // size of file limit for the truncate
+    ::signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &limit), 0);
+    struct rlimit fileLimit = limit;
+    fileLimit.rlim_cur = 1024 * 1024;
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &fileLimit), 0);
+    EXPECT_THROW(blet::conf::SharedDocument::create("/blet_test_sharedDocument_except_limits", conf),
+                 blet::conf::LoadException);
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limit), 0);
+    ::signal(SIGXFSZ, SIG_DFL);
+
+    // size of address space limit for the map
+    std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    std::size_t pages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages;
+    ASSERT_EQ(::getrlimit(RLIMIT_AS, &limit), 0);
+    struct rlimit addressLimit = limit;
+    addressLimit.rlim_cur = pages * pageSize + 8 * 1024 * 1024;
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &addressLimit), 0);
+    EXPECT_THROW(blet::conf::SharedDocument::create("/blet_test_sharedDocument_except_limits", conf),
+                 blet::conf::LoadException);
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &limit), 0);
+
+    blet::conf::SharedDocument::create("/blet_test_sharedDocument_except_limits", conf);
+    blet::conf::SharedDocument document;
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &addressLimit), 0);
+    EXPECT_THROW(document.open("/blet_test_sharedDocument_except_limits"), blet::conf::LoadException);
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &limit), 0);
+    blet::conf::SharedDocument::unlink("/blet_test_sharedDocument_except_limits");
+    EXPECT_FALSE(document.isOpen());
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include "blet/conf.h"
+
+GTEST_TEST(snapshot, publish) {
+    blet::conf::Snapshot snapshot;
+    blet::conf::Snapshot::Reader reader(snapshot);
+    EXPECT_EQ(snapshot.version(), 0);
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_TRUE(guard->isNull());
+        EXPECT_EQ(guard.version(), 0);
+    }
+
+    blet::Dict conf = blet::conf::loadString("[section]\nfoo=42");
+    snapshot.publish(conf);
+    EXPECT_TRUE(conf.isNull());
+    EXPECT_EQ(snapshot.version(), 1);
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_EQ((*guard)["section"]["foo"], 42);
+        EXPECT_EQ(guard.version(), 1);
+    }
+}
+
+GTEST_TEST(snapshot, reclaim) {
+    blet::conf::Snapshot snapshot;
+    blet::conf::Snapshot::Reader reader(snapshot);
+    blet::Dict conf = 42;
+    snapshot.publish(conf);
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        blet::Dict newConf = 24;
+        snapshot.publish(newConf);
+        // the old version is keep for the reader
+        EXPECT_EQ(*guard, 42);
+        EXPECT_EQ(snapshot.reclaim(), 1);
+        {
+            // nested guard use the same version
+            blet::conf::Snapshot::Guard nestedGuard(reader);
+            EXPECT_EQ(*nestedGuard, 42);
+        }
+        EXPECT_EQ(*guard, 42);
+    }
+    EXPECT_EQ(snapshot.reclaim(), 0);
+    blet::conf::Snapshot::Guard guard(reader);
+    EXPECT_EQ(*guard, 24);
+}
+
+GTEST_TEST(snapshot, reader_version) {
+    blet::conf::Snapshot snapshot;
+    blet::Dict conf = 42;
+    snapshot.publish(conf);
+    blet::conf::Snapshot::Reader reader(snapshot);
+    // not locked
+    EXPECT_EQ(reader.version(), 0);
+    reader.lock();
+    EXPECT_EQ(reader.version(), 1);
+    reader.unlock();
+    EXPECT_EQ(reader.version(), 0);
+}
+
+GTEST_TEST(snapshot, retired_destroy) {
+    blet::conf::Snapshot* snapshot = new blet::conf::Snapshot();
+    {
+        blet::conf::Snapshot::Reader reader(*snapshot);
+        blet::conf::Snapshot::Guard guard(reader);
+        blet::Dict conf = 42;
+        snapshot->publish(conf);
+    }
+    // the retired dict is deleted with the snapshot
+    delete snapshot;
+}
+
+struct Block {
+    Block* next;
+};
+
+GTEST_TEST(snapshot, except_reader_alloc) {
+    blet::conf::Snapshot snapshot;
+
+    // size of address space limit
+    std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    std::size_t pages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages;
+    struct rlimit limit;
+    ASSERT_EQ(::getrlimit(RLIMIT_AS, &limit), 0);
+    struct rlimit addressLimit = limit;
+    addressLimit.rlim_cur = pages * pageSize;
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &addressLimit), 0);
+    // take the free memory of the heap
+    Block* blocks = NULL;
+    Block* block;
+    while ((block = static_cast<Block*>(::malloc(sizeof(Block)))) != NULL) {
+        block->next = blocks;
+        blocks = block;
+    }
+    EXPECT_THROW(blet::conf::Snapshot::Reader failReader(snapshot), std::bad_alloc);
+    while (blocks != NULL) {
+        block = blocks->next;
+        ::free(blocks);
+        blocks = block;
+    }
+    ASSERT_EQ(::setrlimit(RLIMIT_AS, &limit), 0);
+}
+
+struct ThreadData {
+    blet::conf::Snapshot* snapshot;
+    bool error;
+};
+
+static void* s_readerThread(void* data) {
+    ThreadData* threadData = static_cast<ThreadData*>(data);
+    blet::conf::Snapshot::Reader reader(*threadData->snapshot);
+    unsigned long lastVersion = 0;
+    for (std::size_t i = 0; i < 20000; ++i) {
+        blet::conf::Snapshot::Guard guard(reader);
+        if (guard.version() < lastVersion || (guard.version() > 0 && (*guard)["version"] != guard.version())) {
+            threadData->error = true;
+        }
+        lastVersion = guard.version();
+    }
+    return NULL;
+}
+
+GTEST_TEST(snapshot, threads) {
+    blet::conf::Snapshot snapshot;
+    ThreadData threadData[4];
+    pthread_t threads[4];
+    for (std::size_t i = 0; i < 4; ++i) {
+        threadData[i].snapshot = &snapshot;
+        threadData[i].error = false;
+        ASSERT_EQ(pthread_create(&threads[i], NULL, &s_readerThread, &threadData[i]), 0);
+    }
+    for (unsigned long version = 1; version <= 1000; ++version) {
+        blet::Dict conf;
+        conf["version"] = version;
+        snapshot.publish(conf);
+    }
+    for (std::size_t i = 0; i < 4; ++i) {
+        pthread_join(threads[i], NULL);
+        EXPECT_FALSE(threadData[i].error);
+    }
+    EXPECT_EQ(snapshot.reclaim(), 0);
+}
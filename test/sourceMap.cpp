@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include "blet/conf.h"
+#include "mock/fileGuard.h"
+
+GTEST_TEST(sourceMap, find) {
+    blet::conf::SourceMap sourceMap;
+    blet::conf::LoadOptions options;
+    options.sourceMap = &sourceMap;
+    blet::Dict conf = blet::conf::loadString(
+        "global=1\n"
+        "[server]\n"
+        "  port = 8080\n"
+        "  aliases = [foo, bar]\n"
+        "  map[key] = 42\n"
+        "  list[] = first\n"
+        "  obj = { \"a.b\" = { c = true } }\n"
+        "[[nested]]\n"
+        "  value = 24\n",
+        options);
+    EXPECT_EQ(conf["server"]["port"], 8080);
+
+    blet::conf::SourceMap::Location location;
+    ASSERT_TRUE(sourceMap.find("global", location));
+    EXPECT_EQ(location.filename, "");
+    EXPECT_EQ(location.offset, 0u);
+    EXPECT_EQ(location.line, 1u);
+    EXPECT_EQ(location.column, 1u);
+
+    ASSERT_TRUE(sourceMap.find("server", location));
+    EXPECT_EQ(location.line, 2u);
+    EXPECT_EQ(location.column, 2u);
+
+    ASSERT_TRUE(sourceMap.find("server.port", location));
+    EXPECT_EQ(location.line, 3u);
+    EXPECT_EQ(location.column, 3u);
+
+    ASSERT_TRUE(sourceMap.find("server.aliases[1]", location));
+    EXPECT_EQ(location.line, 4u);
+    EXPECT_EQ(location.column, 19u);
+
+    ASSERT_TRUE(sourceMap.find("server.map.key", location));
+    EXPECT_EQ(location.line, 5u);
+    EXPECT_EQ(location.column, 6u);
+
+    ASSERT_TRUE(sourceMap.find("server.list[0]", location));
+    EXPECT_EQ(location.line, 6u);
+    EXPECT_EQ(location.column, 7u);
+
+    ASSERT_TRUE(sourceMap.find("server.obj.\"a.b\".c", location));
+    EXPECT_EQ(location.line, 7u);
+    EXPECT_EQ(location.column, 21u);
+
+    ASSERT_TRUE(sourceMap.find("server.nested.value", location));
+    EXPECT_EQ(location.line, 9u);
+    EXPECT_EQ(location.column, 3u);
+
+    EXPECT_FALSE(sourceMap.find("", location));
+    EXPECT_FALSE(sourceMap.find("server.notFound", location));
+    EXPECT_FALSE(sourceMap.find("port", location));
+}
+
+GTEST_TEST(sourceMap, last_assignment) {
+    blet::conf::SourceMap sourceMap;
+    blet::conf::LoadOptions options;
+    options.sourceMap = &sourceMap;
+    blet::conf::loadString(
+        "[section]\n"
+        "foo=1\n"
+        "[other]\n"
+        "[section]\n"
+        "foo=2\n",
+        options);
+
+    blet::conf::SourceMap::Location location;
+    ASSERT_TRUE(sourceMap.find("section.foo", location));
+    EXPECT_EQ(location.line, 5u);
+
+    // a new load clears the records
+    blet::conf::loadString("foo=1", options);
+    EXPECT_EQ(sourceMap.size(), 1u);
+    EXPECT_FALSE(sourceMap.find("section.foo", location));
+}
+
+GTEST_TEST(sourceMap, locate) {
+    const char* testFile = "/tmp/blet_test_sourceMap_locate.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "[server]\nport=80000\nsecure=\"yes\"\naliases=[foo, 42]\n" << std::flush;
+    fileGuard.close();
+
+    blet::conf::SourceMap sourceMap;
+    blet::conf::LoadOptions options;
+    options.sourceMap = &sourceMap;
+    blet::Dict conf = blet::conf::loadFile(testFile, options);
+
+    blet::conf::LoadException exception = sourceMap.locate("server.port", "bad port");
+    EXPECT_STREQ(exception.what(), "Load at /tmp/blet_test_sourceMap_locate.conf:2:1 (bad port)");
+
+    // path not loaded
+    exception = sourceMap.locate("server.host", "no host");
+    EXPECT_STREQ(exception.what(), "Load (no host)");
+    EXPECT_EQ(exception.filename(), "");
+    EXPECT_EQ(exception.line(), 0u);
+
+    // with the schema
+    blet::conf::Schema schema;
+    schema.key("server").key("port").range(1, 65535);
+    std::vector<blet::conf::LoadException> violations = schema.validate(conf, sourceMap);
+    ASSERT_EQ(violations.size(), 1u);
+    EXPECT_EQ(violations[0].line(), 2u);
+    EXPECT_EQ(violations[0].column(), 1u);
+    EXPECT_EQ(violations[0].filename(), testFile);
+
+    // with the binding
+    struct Server {
+        bool secure;
+        std::vector<std::string> aliases;
+    };
+    blet::conf::Binding<Server> binding;
+    binding.field("server.secure", &Server::secure).field("server.aliases", &Server::aliases);
+    Server server;
+    EXPECT_THROW(
+        {
+            try {
+                binding.bind(conf, server, sourceMap);
+            }
+            catch (const blet::conf::BindException& e) {
+                // the error of a vector is located on its invalid element
+                EXPECT_STREQ(e.what(), "Bind (/tmp/blet_test_sourceMap_locate.conf:3:1 server.secure: is not a "
+                                       "boolean (is string), /tmp/blet_test_sourceMap_locate.conf:4:15 "
+                                       "server.aliases[1]: is not a string (is number))");
+                throw;
+            }
+        },
+        blet::conf::BindException);
+}
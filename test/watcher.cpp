@@ -0,0 +1,364 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "blet/conf.h"
+#include "mock/fileGuard.h"
+
+class CountListener : public blet::conf::Watcher::Listener {
+  public:
+    CountListener() :
+        reloads_(0),
+        errors_(0) {
+        pthread_mutex_init(&mutex_, NULL);
+    }
+    ~CountListener() {
+        pthread_mutex_destroy(&mutex_);
+    }
+
+    void onReload(unsigned long /*version*/) {
+        pthread_mutex_lock(&mutex_);
+        ++reloads_;
+        pthread_mutex_unlock(&mutex_);
+    }
+
+    void onError(const blet::conf::LoadException& /*e*/) {
+        pthread_mutex_lock(&mutex_);
+        ++errors_;
+        pthread_mutex_unlock(&mutex_);
+    }
+
+    std::size_t reloads() {
+        pthread_mutex_lock(&mutex_);
+        std::size_t ret = reloads_;
+        pthread_mutex_unlock(&mutex_);
+        return ret;
+    }
+
+    std::size_t errors() {
+        pthread_mutex_lock(&mutex_);
+        std::size_t ret = errors_;
+        pthread_mutex_unlock(&mutex_);
+        return ret;
+    }
+
+  private:
+    pthread_mutex_t mutex_;
+    std::size_t reloads_;
+    std::size_t errors_;
+};
+
+static void s_writeFile(const char* filename, const char* content) {
+    // write and rename like a editor
+    std::string tmpFilename = std::string(filename) + ".swp";
+    std::ofstream ofs(tmpFilename.c_str());
+    ofs << content;
+    ofs.close();
+    ::rename(tmpFilename.c_str(), filename);
+}
+
+static bool s_waitFor(CountListener& listener, std::size_t reloads, std::size_t errors) {
+    for (std::size_t i = 0; i < 500; ++i) {
+        if (listener.reloads() >= reloads && listener.errors() >= errors) {
+            return true;
+        }
+        ::usleep(10000);
+    }
+    return false;
+}
+
+GTEST_TEST(watcher, except_start) {
+    blet::conf::Snapshot snapshot;
+    blet::conf::Watcher watcher("/tmp/blet_test_watcher_not_exists.conf", snapshot);
+    EXPECT_THROW(watcher.start(), blet::conf::LoadException);
+    EXPECT_EQ(snapshot.version(), 0);
+}
+
+GTEST_TEST(watcher, reload) {
+    const char* testFile = "/tmp/blet_test_watcher_reload.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "[section]\nfoo=42" << std::flush;
+    fileGuard.close();
+
+    blet::conf::Snapshot snapshot;
+    blet::conf::Snapshot::Reader reader(snapshot);
+    CountListener listener;
+    blet::conf::Watcher watcher(testFile, snapshot, &listener, 20);
+    watcher.start();
+    EXPECT_EQ(listener.reloads(), 1);
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_EQ((*guard)["section"]["foo"], 42);
+    }
+
+    s_writeFile(testFile, "[section]\nfoo=24");
+    ASSERT_TRUE(s_waitFor(listener, 2, 0));
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_EQ((*guard)["section"]["foo"], 24);
+    }
+
+    // invalid content keep the previous version
+    s_writeFile(testFile, "[section");
+    ASSERT_TRUE(s_waitFor(listener, 2, 1));
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_EQ((*guard)["section"]["foo"], 24);
+    }
+
+    watcher.stop();
+    EXPECT_EQ(listener.reloads(), 2);
+}
+
+GTEST_TEST(watcher, options) {
+    const char* testFile = "/tmp/blet_test_watcher_options.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "url=\"http://${server.host}\"\n[server]\nhost=localhost" << std::flush;
+    fileGuard.close();
+
+    blet::conf::Snapshot snapshot;
+    blet::conf::Snapshot::Reader reader(snapshot);
+    CountListener listener;
+    blet::conf::LoadOptions options;
+    options.interpolation = true;
+    blet::conf::Watcher watcher(testFile, snapshot, &listener, 20, options);
+    watcher.start();
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_EQ((*guard)["url"], "http://localhost");
+    }
+
+    // the references are still resolved after a reload
+    s_writeFile(testFile, "url=\"http://${server.host}:${server.port}\"\n[server]\nhost=example\nport=8080");
+    ASSERT_TRUE(s_waitFor(listener, 2, 0));
+    {
+        blet::conf::Snapshot::Guard guard(reader);
+        EXPECT_EQ((*guard)["url"], "http://example:8080");
+    }
+    watcher.stop();
+}
+
+GTEST_TEST(watcher, watch) {
+    const char* testFile = "/tmp/blet_test_watcher_watch.conf";
+    const char* includeFile = "/tmp/blet_test_watcher_watch_include.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "foo=42" << std::flush;
+    fileGuard.close();
+    test::blet::FileGuard includeGuard(includeFile, std::ofstream::out | std::ofstream::trunc);
+    includeGuard.close();
+
+    blet::conf::Snapshot snapshot;
+    CountListener listener;
+    blet::conf::Watcher watcher(testFile, snapshot, &listener, 20);
+    watcher.watch(includeFile);
+    watcher.start();
+
+    // a change of watched file reload the config
+    s_writeFile(includeFile, "bar=24");
+    ASSERT_TRUE(s_waitFor(listener, 2, 0));
+    EXPECT_EQ(snapshot.version(), 2);
+}
+
+GTEST_TEST(watcher, directories) {
+    ::mkdir("/tmp/blet_test_watcher_directories_a", 0755);
+    ::mkdir("/tmp/blet_test_watcher_directories_b", 0755);
+    const char* testFile = "/tmp/blet_test_watcher_directories_a/conf.conf";
+    const char* otherFile = "/tmp/blet_test_watcher_directories_b/conf.conf";
+    const char* watchFile = "/tmp/blet_test_watcher_directories_b/watch.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "foo=42" << std::flush;
+    fileGuard.close();
+    test::blet::FileGuard otherGuard(otherFile, std::ofstream::out | std::ofstream::trunc);
+    otherGuard.close();
+    test::blet::FileGuard watchGuard(watchFile, std::ofstream::out | std::ofstream::trunc);
+    watchGuard.close();
+
+    blet::conf::Snapshot snapshot;
+    CountListener listener;
+    blet::conf::Watcher watcher(testFile, snapshot, &listener, 20);
+    watcher.watch(watchFile);
+    watcher.start();
+    // already started
+    watcher.start();
+    EXPECT_EQ(listener.reloads(), 1);
+
+    // same basename in a other watched directory
+    s_writeFile(otherFile, "foo=24");
+    ::usleep(200000);
+    EXPECT_EQ(listener.reloads(), 1);
+
+    s_writeFile(watchFile, "foo=24");
+    ASSERT_TRUE(s_waitFor(listener, 2, 0));
+    watcher.stop();
+    EXPECT_EQ(listener.reloads(), 2);
+    ::rmdir("/tmp/blet_test_watcher_directories_a");
+    ::rmdir("/tmp/blet_test_watcher_directories_b");
+}
+
+GTEST_TEST(watcher, relative) {
+    // file in current directory and a file in root directory
+    const char* testFile = "blet_test_watcher_relative.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "foo=42" << std::flush;
+    fileGuard.close();
+
+    blet::conf::Snapshot snapshot;
+    CountListener listener;
+    blet::conf::Watcher watcher(testFile, snapshot, &listener, 20);
+    watcher.watch("/blet_test_watcher_relative.conf");
+    watcher.start();
+    s_writeFile(testFile, "foo=24");
+    ASSERT_TRUE(s_waitFor(listener, 2, 0));
+    EXPECT_EQ(snapshot.version(), 2);
+}
+
+class ThrowListener : public CountListener {
+  public:
+    ThrowListener(int type) :
+        CountListener(),
+        type_(type),
+        calls_(0) {}
+
+    void onReload(unsigned long version) {
+        CountListener::onReload(version);
+        // the first call is in start
+        if (++calls_ > 1) {
+            if (type_ == 0) {
+                throw std::runtime_error("Listener failed");
+            }
+            throw type_;
+        }
+    }
+
+    void onError(const blet::conf::LoadException& e) {
+        message_ = e.message();
+        CountListener::onError(e);
+    }
+
+    std::string message_;
+
+  private:
+    int type_;
+    std::size_t calls_;
+};
+
+GTEST_TEST(watcher, except_reload) {
+    const char* testFile = "/tmp/blet_test_watcher_except_reload.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "foo=42" << std::flush;
+    fileGuard.close();
+
+    for (int type = 0; type < 2; ++type) {
+        blet::conf::Snapshot snapshot;
+        ThrowListener listener(type);
+        blet::conf::Watcher watcher(testFile, snapshot, &listener, 20);
+        watcher.start();
+        // the thread of watcher is alive after the exception of listener
+        s_writeFile(testFile, "foo=24");
+        ASSERT_TRUE(s_waitFor(listener, 2, 1));
+        s_writeFile(testFile, "foo=42");
+        ASSERT_TRUE(s_waitFor(listener, 3, 2));
+        watcher.stop();
+        EXPECT_EQ(listener.message_, type == 0 ? "Listener failed" : "Reload failed");
+    }
+}
+
+GTEST_TEST(watcher, except_watch) {
+    const char* testFile = "/tmp/blet_test_watcher_except_watch.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "foo=42" << std::flush;
+    fileGuard.close();
+
+    {
+        // directory not found
+        blet::conf::Snapshot snapshot;
+        blet::conf::Watcher watcher(testFile, snapshot);
+        watcher.watch("/tmp/blet_test_watcher_not_exists/include.conf");
+        EXPECT_THROW(watcher.start(), blet::conf::LoadException);
+        EXPECT_EQ(snapshot.version(), 0);
+    }
+
+    // the first free file descriptor
+    int fd = ::open("/dev/null", O_RDONLY);
+    ASSERT_NE(fd, -1);
+    ::close(fd);
+    struct rlimit limit;
+    ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &limit), 0);
+    for (rlim_t size = fd; size <= static_cast<rlim_t>(fd + 1); ++size) {
+        // without file descriptor for inotify then for the pipe
+        blet::conf::Snapshot snapshot;
+        blet::conf::Watcher watcher(testFile, snapshot);
+        struct rlimit newLimit = limit;
+        newLimit.rlim_cur = size;
+        ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &newLimit), 0);
+        EXPECT_THROW(watcher.start(), blet::conf::LoadException);
+        ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &limit), 0);
+        EXPECT_EQ(snapshot.version(), 0);
+    }
+
+    // the file descriptors are closed
+    int lastFd = ::open("/dev/null", O_RDONLY);
+    EXPECT_EQ(lastFd, fd);
+    ::close(lastFd);
+}
+
+#ifdef __GLIBC__
+
+/**
+ * @brief Restore the default attributes of threads changed by a test (glibc only).
+ */
+class watcherDefaultThreadAttr : public ::testing::Test {
+  protected:
+    void SetUp() {
+        ASSERT_EQ(::pthread_getattr_default_np(&attr_), 0);
+    }
+
+    void TearDown() {
+        ::pthread_setattr_default_np(&attr_);
+        ::pthread_attr_destroy(&attr_);
+    }
+
+    /**
+     * @brief Set a default stack larger than any address space, the next threads are not created.
+     */
+    void setStackTooLarge() {
+        pthread_attr_t largeAttr;
+        ASSERT_EQ(::pthread_getattr_default_np(&largeAttr), 0);
+        ASSERT_EQ(::pthread_attr_setstacksize(&largeAttr, static_cast<std::size_t>(1) << 62), 0);
+        ASSERT_EQ(::pthread_setattr_default_np(&largeAttr), 0);
+        ::pthread_attr_destroy(&largeAttr);
+    }
+
+    pthread_attr_t attr_;
+};
+
+TEST_F(watcherDefaultThreadAttr, except_thread) {
+    const char* testFile = "/tmp/blet_test_watcher_except_thread.conf";
+    test::blet::FileGuard fileGuard(testFile, std::ofstream::out | std::ofstream::trunc);
+    fileGuard << "foo=42" << std::flush;
+    fileGuard.close();
+
+    int fd = ::open("/dev/null", O_RDONLY);
+    ASSERT_NE(fd, -1);
+    ::close(fd);
+
+    blet::conf::Snapshot snapshot;
+    blet::conf::Watcher watcher(testFile, snapshot);
+    setStackTooLarge();
+    EXPECT_THROW(watcher.start(), blet::conf::LoadException);
+    // the published config is kept
+    EXPECT_EQ(snapshot.version(), 1);
+
+    // the file descriptors are closed
+    int lastFd = ::open("/dev/null", O_RDONLY);
+    EXPECT_EQ(lastFd, fd);
+    ::close(lastFd);
+}
+
+#endif